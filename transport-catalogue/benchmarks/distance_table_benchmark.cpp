@@ -0,0 +1,132 @@
+// Сравнение distances::DistanceTable с прежним хранением расстояний:
+// unordered_map по паре указателей на остановки с PointersPairHasher.
+// Синтетический город: остановки, у каждой несколько соседей с заданным расстоянием,
+// поиск случайных заданных пар в обоих направлениях, как это делает GetDistance.
+// Запуск: distance_table_benchmark [stops] [neighbours] [lookups]
+
+#include "../distance_table.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    // Остановка того же порядка размера, что domain::Stop до перехода на id
+    struct Stop {
+        std::string name;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        uint32_t id = 0U;
+    };
+
+    class PointersPairHasher {
+    public:
+        size_t operator()(const std::pair<const Stop*, const Stop*> pointers) const noexcept {
+            static const size_t shift = static_cast<size_t>(std::log2(1 + sizeof(Stop)));
+            return (reinterpret_cast<size_t>(pointers.first) >> shift)
+                + (reinterpret_cast<size_t>(pointers.second) >> shift * 7);
+        }
+    };
+
+    using MapStopsDistances = std::unordered_map<std::pair<const Stop*, const Stop*>, size_t, PointersPairHasher>;
+
+    // Прежний TransportCatalogue::GetDistance: count и at в прямом, затем в обратном направлении
+    size_t GetDistance(const MapStopsDistances& distances, const Stop* from, const Stop* to) {
+        if (distances.count({ from, to }) != 0) {
+            return distances.at({ from, to });
+        }
+        if (distances.count({ to, from }) != 0) {
+            return distances.at({ to, from });
+        }
+        return 0U;
+    }
+
+    template <typename Function>
+    double MeasureNanoseconds(size_t operations, Function function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(operations);
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t stop_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000U;
+    const size_t neighbours = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4U;
+    const size_t lookup_count = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000000U;
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint32_t> stop_distribution(0U, static_cast<uint32_t>(stop_count - 1));
+    std::uniform_int_distribution<uint32_t> distance_distribution(100U, 10000U);
+
+    std::deque<Stop> stops;
+    for (size_t i = 0; i != stop_count; ++i) {
+        stops.push_back({ "Stop "s + std::to_string(i), 0.0, 0.0, static_cast<uint32_t>(i) });
+    }
+
+    // Заданные направленные расстояния
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    pairs.reserve(stop_count * neighbours);
+    for (uint32_t from = 0; from != stop_count; ++from) {
+        for (size_t i = 0; i != neighbours; ++i) {
+            pairs.emplace_back(from, stop_distribution(generator));
+        }
+    }
+
+    MapStopsDistances map;
+    distances::DistanceTable table;
+    for (const auto& [from, to] : pairs) {
+        const uint32_t distance = distance_distribution(generator);
+        map.insert({ { &stops[from], &stops[to] }, distance });
+        table.Add(from, to, distance);
+    }
+
+    // Половина запросов - в обратном направлении, как для расстояний, заданных одной стороной
+    std::vector<std::pair<uint32_t, uint32_t>> lookups;
+    lookups.reserve(lookup_count);
+    for (size_t i = 0; i != lookup_count; ++i) {
+        const auto [from, to] = pairs[generator() % pairs.size()];
+        if (generator() % 2 == 0) {
+            lookups.emplace_back(from, to);
+        }
+        else {
+            lookups.emplace_back(to, from);
+        }
+    }
+
+    uint64_t map_sum = 0U;
+    const double map_ns = MeasureNanoseconds(lookups.size(), [&] {
+        for (const auto& [from, to] : lookups) {
+            map_sum += GetDistance(map, &stops[from], &stops[to]);
+        }
+    });
+
+    uint64_t table_sum = 0U;
+    const double table_ns = MeasureNanoseconds(lookups.size(), [&] {
+        for (const auto& [from, to] : lookups) {
+            table_sum += table.Get(from, to);
+        }
+    });
+
+    std::cout << "stops="sv << stop_count << " distances="sv << table.size() << " lookups="sv << lookups.size() << '\n'
+        << "unordered_map<pair<Stop*, Stop*>>: "sv << map_ns << " ns/lookup\n"sv
+        << "DistanceTable: "sv << table_ns << " ns/lookup, "sv << table.GetMemoryUsage() / 1024 << " KiB\n"sv;
+
+    if (map_sum != table_sum) {
+        std::cerr << "checksum mismatch: "sv << map_sum << " != "sv << table_sum << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Разбор и запись чисел JSON: std::from_chars/std::to_chars в json против прежних
+// std::string + stoi/stod при разборе и ostream << при выводе.
+// Документ генерируется здесь же: массив объектов с координатами, расстоянием и временем,
+// числа из него разбираются и записываются по отдельности.
+// Запуск: json_number_benchmark [objects]
+
+#include "../json.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    std::string MakeDocument(size_t objects) {
+        std::mt19937 generator(49);
+        std::uniform_real_distribution<double> latitude(43.5, 43.7);
+        std::uniform_real_distribution<double> longitude(39.6, 39.8);
+        std::uniform_int_distribution<int> distance(100, 100000);
+        std::uniform_real_distribution<double> time(0.0, 120.0);
+
+        std::ostringstream out;
+        out.precision(17);
+        out << '[';
+        for (size_t i = 0; i != objects; ++i) {
+            out << (i == 0 ? ""sv : ","sv)
+                << "{\"lat\":"sv << latitude(generator)
+                << ",\"lng\":"sv << longitude(generator)
+                << ",\"distance\":"sv << distance(generator)
+                << ",\"time\":"sv << time(generator) << '}';
+        }
+        out << ']';
+        return out.str();
+    }
+
+    using Number = std::variant<int, double>;
+
+    // Текст чисел документа в порядке появления: каждое стоит после ':' до ',' или '}'
+    std::vector<std::string_view> CollectNumbers(std::string_view text) {
+        std::vector<std::string_view> numbers;
+        for (size_t pos = text.find(':'); pos != std::string_view::npos; pos = text.find(':', pos)) {
+            const size_t end = text.find_first_of(",}"sv, ++pos);
+            numbers.push_back(text.substr(pos, end - pos));
+            pos = end;
+        }
+        return numbers;
+    }
+
+    // Прежний Parser::ParseNumber после проверки грамматики
+    Number ParseWithStod(std::string_view text) {
+        const std::string parsed_num(text);
+        const bool is_int = parsed_num.find_first_of(".eE"sv) == std::string::npos;
+        try {
+            if (is_int) {
+                try {
+                    return std::stoi(parsed_num);
+                }
+                catch (...) {
+                }
+            }
+            return std::stod(parsed_num);
+        }
+        catch (...) {
+            throw json::ParsingError("Failed to convert "s + parsed_num + " to number"s);
+        }
+    }
+
+    double ToDouble(const Number& number) {
+        return std::visit([](auto value) {
+            return static_cast<double>(value);
+        }, number);
+    }
+
+    template <typename Function>
+    double MeasureMilliseconds(Function function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Числа документа в том же порядке в формате format, через json::Writer
+    std::string WriteNumbers(const std::vector<Number>& numbers, json::DoubleFormat format) {
+        std::ostringstream out;
+        {
+            json::Writer writer(out, format);
+            writer.StartArray();
+            for (const Number& number : numbers) {
+                std::visit([&writer](auto value) {
+                    writer.Value(value);
+                }, number);
+            }
+            writer.EndArray();
+        }
+        return out.str();
+    }
+
+    // Прежний вывод Writer: отступы те же, числа через ostream <<
+    std::string WriteNumbersWithStream(const std::vector<Number>& numbers) {
+        std::ostringstream out;
+        out << "[\n"sv;
+        bool first = true;
+        for (const Number& number : numbers) {
+            out << (first ? "    "sv : ",\n    "sv);
+            first = false;
+            std::visit([&out](auto value) {
+                out << value;
+            }, number);
+        }
+        out << "\n]"sv;
+        return out.str();
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t object_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 400000U;
+
+    const std::string text = MakeDocument(object_count);
+    const std::vector<std::string_view> texts = CollectNumbers(text);
+
+    // Разбор: те же числа через json::Parser и прежним способом
+    std::vector<Number> numbers;
+    numbers.reserve(texts.size());
+    const double from_chars_ms = MeasureMilliseconds([&] {
+        for (const std::string_view number : texts) {
+            numbers.push_back(json::Parser(number).ReadNumber());
+        }
+    });
+    std::vector<Number> stod_numbers;
+    stod_numbers.reserve(texts.size());
+    const double stod_ms = MeasureMilliseconds([&] {
+        for (const std::string_view number : texts) {
+            stod_numbers.push_back(ParseWithStod(number));
+        }
+    });
+
+    std::string stream_text;
+    const double stream_ms = MeasureMilliseconds([&] {
+        stream_text = WriteNumbersWithStream(numbers);
+    });
+    std::string writer_text;
+    const double writer_ms = MeasureMilliseconds([&] {
+        writer_text = WriteNumbers(numbers, json::DoubleFormat::stream);
+    });
+    std::string shortest_text;
+    const double shortest_ms = MeasureMilliseconds([&] {
+        shortest_text = WriteNumbers(numbers, json::DoubleFormat::shortest);
+    });
+
+    std::cout << "objects="sv << object_count << " numbers="sv << texts.size()
+        << " document="sv << text.size() / 1024 << " KiB\n"sv
+        << "Parser::ReadNumber, from_chars: "sv << from_chars_ms << " ms\n"sv
+        << "string + stoi/stod: "sv << stod_ms << " ms\n"sv
+        << "ostream <<: "sv << stream_ms << " ms, "sv << stream_text.size() / 1024 << " KiB\n"sv
+        << "Writer, DoubleFormat::stream: "sv << writer_ms << " ms, "sv << writer_text.size() / 1024 << " KiB\n"sv
+        << "Writer, DoubleFormat::shortest: "sv << shortest_ms << " ms, "sv << shortest_text.size() / 1024 << " KiB\n"sv;
+
+    // Оба способа разбора дают те же числа, а формат stream - тот же текст, что ostream
+    if (stod_numbers != numbers) {
+        std::cerr << "stoi/stod numbers differ from Parser::ReadNumber\n"sv;
+        return 1;
+    }
+    if (writer_text != stream_text) {
+        std::cerr << "DoubleFormat::stream differs from ostream output\n"sv;
+        return 1;
+    }
+    // Кратчайшая запись читается обратно в те же числа; целое значение double
+    // в ней записано без точки и читается как int, поэтому сравниваются значения
+    json::Parser shortest(shortest_text);
+    shortest.StartArray();
+    for (const Number& number : numbers) {
+        if (!shortest.NextElement() || ToDouble(shortest.ReadNumber()) != ToDouble(number)) {
+            std::cerr << "DoubleFormat::shortest does not round-trip\n"sv;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "catalogue_snapshot.h"
+
+#include <atomic>
+#include <sstream>
+
+namespace transport_catalogue {
+
+	namespace snapshot {
+
+		CatalogueSnapshot::CatalogueSnapshot(uint64_t version,
+			std::shared_ptr<const TransportCatalogue> catalogue,
+			std::shared_ptr<router::TransportRouter> router,
+			std::shared_ptr<const map_renderer::MapRenderer> renderer)
+			: version_(version)
+			, catalogue_(std::move(catalogue))
+			, router_(std::move(router))
+			, renderer_(std::move(renderer)) {
+		}
+
+		uint64_t CatalogueSnapshot::GetVersion() const {
+			return version_;
+		}
+
+		const TransportCatalogue& CatalogueSnapshot::GetCatalogue() const {
+			return *catalogue_;
+		}
+
+		const StopStat* CatalogueSnapshot::GetStop(std::string_view stop) const {
+			return catalogue_->GetBusesForStopInfo(stop);
+		}
+
+		const BusStat* CatalogueSnapshot::GetBus(std::string_view bus) const {
+			return catalogue_->GetBusInfo(bus);
+		}
+
+		RouteStat CatalogueSnapshot::GetRoute(std::string_view from, std::string_view to) const {
+			if (!router_) {
+				return {};
+			}
+			return router_->MakeRoute(from, to);
+		}
+
+		RouteStat CatalogueSnapshot::GetRouteToAny(std::string_view from,
+			const std::pmr::vector<std::pmr::string>& to_any) const {
+			if (!router_) {
+				return {};
+			}
+			std::vector<std::string_view> targets(to_any.begin(), to_any.end());
+			return router_->MakeRouteToAny(from, targets);
+		}
+
+		RouteStat CatalogueSnapshot::GetRouteToBus(std::string_view from, std::string_view bus) const {
+			const Bus* bus_ptr = catalogue_->FindRouteByName(bus);
+			if (bus_ptr == nullptr || !router_) {
+				return {};
+			}
+			std::vector<std::string_view> targets;
+			targets.reserve(bus_ptr->stops_.size());
+			for (const Stop* stop : bus_ptr->stops_) {
+				targets.push_back(stop->name_);
+			}
+			return router_->MakeRouteToAny(from, targets);
+		}
+
+		ConnectionStat CatalogueSnapshot::GetConnection(std::string_view from, std::string_view to) const {
+			return catalogue_->GetDirectConnections(from, to);
+		}
+
+		NearbyStopsStat CatalogueSnapshot::GetNearestStops(const geo::Coordinates& point, size_t count) const {
+			return catalogue_->GetNearestStops(point, count);
+		}
+
+		NearbyStopsStat CatalogueSnapshot::GetStopsInRadius(const geo::Coordinates& point, double radius) const {
+			return catalogue_->GetStopsInRadius(point, radius);
+		}
+
+		NearbyStopsStat CatalogueSnapshot::GetStopsInBox(const geo::Coordinates& min, const geo::Coordinates& max) const {
+			return catalogue_->GetStopsInBox(min, max);
+		}
+
+		StopSearchStat CatalogueSnapshot::SearchStops(std::string_view prefix, size_t limit, size_t max_edits) const {
+			return catalogue_->SearchStops(prefix, limit, max_edits);
+		}
+
+		std::string CatalogueSnapshot::GetMap() const {
+			std::ostringstream strm;
+			renderer_->RenderMap(*catalogue_).Render(strm);
+
+			return strm.str();
+		}
+
+		std::shared_ptr<const CatalogueSnapshot> VersionedCatalogue::Acquire() const {
+			return std::atomic_load(&current_);
+		}
+
+		void VersionedCatalogue::Publish(std::shared_ptr<const CatalogueSnapshot> snapshot) {
+			std::atomic_store(&current_, std::move(snapshot));
+		}
+
+	}
+
+}
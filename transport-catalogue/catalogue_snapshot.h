@@ -0,0 +1,66 @@
+#pragma once
+
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace transport_catalogue {
+
+	namespace snapshot {
+
+		// Неизменяемая версия каталога вместе с построенными по ней маршрутизатором и отрисовщиком.
+		// Запросы Bus/Stop/Route/Map/Connect выполняются только через снимок и не меняют его,
+		// поэтому один снимок читают сколько угодно потоков. Части, не затронутые обновлением,
+		// следующая версия получает теми же объектами
+		class CatalogueSnapshot {
+		public:
+			CatalogueSnapshot(uint64_t version,
+				std::shared_ptr<const TransportCatalogue> catalogue,
+				std::shared_ptr<router::TransportRouter> router,
+				std::shared_ptr<const map_renderer::MapRenderer> renderer);
+
+			uint64_t GetVersion() const;
+			const TransportCatalogue& GetCatalogue() const;
+
+			// Указатели на записи ответов действительны, пока жив снимок
+			const StopStat* GetStop(std::string_view stop) const;
+			const BusStat* GetBus(std::string_view bus) const;
+			RouteStat GetRoute(std::string_view from, std::string_view to) const;
+			RouteStat GetRouteToAny(std::string_view from, const std::pmr::vector<std::pmr::string>& to_any) const;
+			RouteStat GetRouteToBus(std::string_view from, std::string_view bus) const;
+			ConnectionStat GetConnection(std::string_view from, std::string_view to) const;
+			NearbyStopsStat GetNearestStops(const geo::Coordinates& point, size_t count) const;
+			NearbyStopsStat GetStopsInRadius(const geo::Coordinates& point, double radius) const;
+			NearbyStopsStat GetStopsInBox(const geo::Coordinates& min, const geo::Coordinates& max) const;
+			StopSearchStat SearchStops(std::string_view prefix, size_t limit, size_t max_edits) const;
+			std::string GetMap() const;
+
+		private:
+			uint64_t version_;
+			std::shared_ptr<const TransportCatalogue> catalogue_;
+			// Граф маршрутизатора строится лениво при первом запросе Route под std::call_once
+			std::shared_ptr<router::TransportRouter> router_;
+			std::shared_ptr<const map_renderer::MapRenderer> renderer_;
+		};
+
+		// Текущая опубликованная версия. Читатель атомарно берёт указатель на снимок и держит его
+		// до конца запроса, писатель готовит следующий снимок отдельно и подменяет указатель,
+		// не дожидаясь читателей. Старый снимок освобождается вместе с последним читателем
+		class VersionedCatalogue {
+		public:
+			std::shared_ptr<const CatalogueSnapshot> Acquire() const;
+			void Publish(std::shared_ptr<const CatalogueSnapshot> snapshot);
+
+		private:
+			std::shared_ptr<const CatalogueSnapshot> current_ = nullptr;
+		};
+
+	}
+
+}
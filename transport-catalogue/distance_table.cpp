@@ -0,0 +1,87 @@
+#include "distance_table.h"
+
+namespace distances {
+
+    void DistanceTable::Add(uint32_t from, uint32_t to, uint32_t distance) {
+        if (distance == 0U) {
+            return;
+        }
+
+        uint32_t& target = Emplace(from, to);
+        if (target == 0U) {
+            target = distance;
+            ++size_;
+        }
+    }
+
+    void DistanceTable::Set(uint32_t from, uint32_t to, uint32_t distance) {
+        if (distance == 0U) {
+            return;
+        }
+
+        uint32_t& target = Emplace(from, to);
+        if (target == 0U) {
+            ++size_;
+        }
+        target = distance;
+    }
+
+    uint32_t& DistanceTable::Emplace(uint32_t from, uint32_t to) {
+        // Заполненность держим не выше половины, чтобы цепочки проб оставались короткими
+        if ((used_slots_ + 1) * 2 > slots_.size()) {
+            Rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+        }
+
+        const uint64_t key = MakeKey(from, to);
+        Slot& slot = slots_[FindSlot(key)];
+        if (slot.key == EMPTY_KEY) {
+            slot.key = key;
+            ++used_slots_;
+        }
+        return slot.distance[from < to ? 0 : 1];
+    }
+
+    uint32_t DistanceTable::Get(uint32_t from, uint32_t to) const {
+        if (slots_.empty()) {
+            return 0U;
+        }
+        const Slot& slot = slots_[FindSlot(MakeKey(from, to))];
+        const size_t direction = from < to ? 0 : 1;
+
+        return slot.distance[direction] != 0U ? slot.distance[direction] : slot.distance[1 - direction];
+    }
+
+    uint32_t DistanceTable::GetDirected(uint32_t from, uint32_t to) const {
+        if (slots_.empty()) {
+            return 0U;
+        }
+        return slots_[FindSlot(MakeKey(from, to))].distance[from < to ? 0 : 1];
+    }
+
+    size_t DistanceTable::FindSlot(uint64_t key) const {
+        // Фибоначчиево хеширование: старшие биты произведения хорошо перемешаны
+        const size_t mask = slots_.size() - 1;
+        size_t index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+        while (slots_[index].key != key && slots_[index].key != EMPTY_KEY) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void DistanceTable::Rehash(size_t capacity) {
+        std::vector<Slot> old_slots(capacity);
+        old_slots.swap(slots_);
+
+        shift_ = 64U;
+        for (size_t bits = capacity; bits > 1; bits >>= 1) {
+            --shift_;
+        }
+
+        for (const Slot& slot : old_slots) {
+            if (slot.key != EMPTY_KEY) {
+                slots_[FindSlot(slot.key)] = slot;
+            }
+        }
+    }
+
+}  // namespace distances
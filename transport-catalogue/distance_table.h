@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace distances {
+
+    // Таблица дорожных расстояний между остановками с открытой адресацией.
+    // Ключ - упакованная в 64 бита неупорядоченная пара id остановок (меньший id в старших битах),
+    // в одной ячейке хранятся оба направления, поэтому обратное направление
+    // находится той же пробой без повторного поиска
+    class DistanceTable {
+    public:
+        DistanceTable() = default;
+
+        // Сохраняет расстояние from -> to, если оно ещё не задано
+        void Add(uint32_t from, uint32_t to, uint32_t distance);
+
+        // Сохраняет расстояние from -> to, заменяя заданное ранее
+        void Set(uint32_t from, uint32_t to, uint32_t distance);
+
+        // Расстояние from -> to, а если оно не задано - расстояние to -> from; 0 если нет ни одного
+        uint32_t Get(uint32_t from, uint32_t to) const;
+
+        // Расстояние строго в направлении from -> to, 0 если не задано
+        uint32_t GetDirected(uint32_t from, uint32_t to) const;
+
+        // Количество заданных направленных расстояний
+        size_t size() const {
+            return size_;
+        }
+
+        // Обходит все заданные направленные расстояния: action(from, to, distance)
+        template <typename Action>
+        void ForEach(Action action) const;
+
+        size_t GetMemoryUsage() const {
+            return slots_.capacity() * sizeof(Slot);
+        }
+
+    private:
+        static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+        static constexpr size_t MIN_CAPACITY = 16U;
+
+        struct Slot {
+            uint64_t key = EMPTY_KEY;
+            // [0] - от меньшего id к большему, [1] - обратно
+            uint32_t distance[2] = { 0U, 0U };
+        };
+
+        static uint64_t MakeKey(uint32_t from, uint32_t to) {
+            return from < to
+                ? (static_cast<uint64_t>(from) << 32) | to
+                : (static_cast<uint64_t>(to) << 32) | from;
+        }
+
+        size_t FindSlot(uint64_t key) const;
+        // Ячейка направления from -> to, слот создаётся при отсутствии
+        uint32_t& Emplace(uint32_t from, uint32_t to);
+        void Rehash(size_t capacity);
+
+        std::vector<Slot> slots_;
+        size_t used_slots_ = 0U;
+        size_t size_ = 0U;
+        uint32_t shift_ = 64U;
+    };
+
+    template <typename Action>
+    void DistanceTable::ForEach(Action action) const {
+        for (const Slot& slot : slots_) {
+            if (slot.key == EMPTY_KEY) {
+                continue;
+            }
+            const uint32_t low = static_cast<uint32_t>(slot.key >> 32);
+            const uint32_t high = static_cast<uint32_t>(slot.key);
+            if (slot.distance[0] != 0U) {
+                action(low, high, slot.distance[0]);
+            }
+            if (slot.distance[1] != 0U) {
+                action(high, low, slot.distance[1]);
+            }
+        }
+    }
+
+}  // namespace distances
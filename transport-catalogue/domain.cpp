@@ -12,13 +12,13 @@ namespace domain {
 	}
 
 	Stop::Stop(Stop* other) :
-		name_(other->name_), coordinates_(other->coordinates_)
+		name_(other->name_), coordinates_(other->coordinates_), id_(other->id_)
 	{
 	}
 
 	Stop& Stop::SetStopName(std::string_view stop_name)
 	{
-		name_ = std::string(stop_name);
+		name_ = stop_name;
 		return *this;
 	}
 
@@ -41,12 +41,7 @@ namespace domain {
 		return *this;
 	}
 
-	const std::string& Stop::GetStopName() const
-	{
-		return name_;
-	}
-
-	std::string Stop::GetStopName()
+	std::string_view Stop::GetStopName() const
 	{
 		return name_;
 	}
@@ -66,13 +61,18 @@ namespace domain {
 	{
 	}
 
+	Bus::Bus(std::pmr::memory_resource* resource) :
+		stops_(resource)
+	{
+	}
+
 	Bus& Bus::SetBusName(std::string_view route_name)
 	{
-		bus_name_ = std::string(route_name);
+		bus_name_ = route_name;
 		return *this;
 	}
 
-	Bus& Bus::SetStops(std::vector<Stop*>&& stops)
+	Bus& Bus::SetStops(StopsList&& stops)
 	{
 		stops_ = std::move(stops);
 		return *this;
@@ -108,16 +108,21 @@ namespace domain {
 		return *this;
 	}
 
-	const std::string& Bus::GetBusName() const
+	std::string_view Bus::GetBusName() const
 	{
 		return bus_name_;
 	}
 
-	const std::vector<Stop*>& Bus::GetStops() const
+	const StopsList& Bus::GetStops() const
 	{
 		return stops_;
 	}
 
+	ranges::RouteRange<StopsList::const_iterator> Bus::GetRouteStops() const
+	{
+		return { stops_.begin(), stops_.end(), is_circular_ };
+	}
+
 	bool Bus::GetBusType() const
 	{
 		return is_circular_;
@@ -143,22 +148,40 @@ namespace domain {
 		return route_curvature_;
 	}
 
-	StopStat::StopStat(std::string_view name, std::set<std::string_view>& buses) :
-		stop_name_(name), buses_(buses)
-	{
-	}
-
 	BusStat::BusStat(std::string_view name, size_t stops, size_t unique_stops, size_t dist, double curvature) :
 		bus_name_(name), bus_stops_num_(stops), unique_stops_num_(unique_stops),
 		route_length_(dist), route_curvature_(curvature)
 	{
 	}
 
-	std::size_t PointersPairHasher::operator()(const std::pair<Stop*, Stop*> pointers) const noexcept
+	Request::Request(const allocator_type& alloc) :
+		key_(alloc), name_(alloc), from_(alloc), to_(alloc),
+		stops_(alloc), to_any_(alloc), to_bus_(alloc), distances_(alloc), prefix_(alloc)
 	{
-		static const size_t shift = (size_t)log2(1 + sizeof(Stop));
-		return ((size_t)(pointers.first) >> shift) + ((size_t)(pointers.second) >> shift * 7);
+	}
 
+	Request::Request(const Request& other, const allocator_type& alloc) :
+		id_(other.id_), type_(other.type_),
+		key_(other.key_, alloc), name_(other.name_, alloc), from_(other.from_, alloc), to_(other.to_, alloc),
+		coordinates_(other.coordinates_),
+		stops_(other.stops_, alloc), to_any_(other.to_any_, alloc), to_bus_(other.to_bus_, alloc),
+		distances_(other.distances_, alloc), is_circular_(other.is_circular_), position_(other.position_),
+		count_(other.count_), radius_(other.radius_), max_coordinates_(other.max_coordinates_),
+		prefix_(other.prefix_, alloc), max_edits_(other.max_edits_)
+	{
+	}
+
+	Request::Request(Request&& other, const allocator_type& alloc) :
+		id_(other.id_), type_(other.type_),
+		key_(std::move(other.key_), alloc), name_(std::move(other.name_), alloc),
+		from_(std::move(other.from_), alloc), to_(std::move(other.to_), alloc),
+		coordinates_(other.coordinates_),
+		stops_(std::move(other.stops_), alloc), to_any_(std::move(other.to_any_), alloc),
+		to_bus_(std::move(other.to_bus_), alloc),
+		distances_(std::move(other.distances_), alloc), is_circular_(other.is_circular_), position_(other.position_),
+		count_(other.count_), radius_(other.radius_), max_coordinates_(other.max_coordinates_),
+		prefix_(std::move(other.prefix_), alloc), max_edits_(other.max_edits_)
+	{
 	}
 
 	RouteItem& RouteItem::SetName(std::string_view name) {
@@ -2,17 +2,24 @@
 
 #include "geo.h"
 #include "graph.h"
+#include "ranges.h"
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <set>
 #include <map>
+#include <optional>
+#include <memory_resource>
 #include <vector>
 #include <unordered_map>
 
 using namespace std::literals;
 
 namespace domain {
+
+	using StopId = uint32_t;
+	using BusId = uint32_t;
 	
 	struct Stop {
 		Stop() = default;
@@ -25,58 +32,69 @@ namespace domain {
 		Stop& SetStopCoordinates(const geo::Coordinates& coordinates);
 		Stop& SetStopCoordinates(geo::Coordinates&& coordinates);
 
-		const std::string& GetStopName() const;
-		std::string GetStopName();
+		std::string_view GetStopName() const;
 		const geo::Coordinates& GetStopCoordinates() const;
 		geo::Coordinates GetStopCoordinates();
 
-		std::string name_;
+		// До добавления в каталог указывает на строку вызывающего,
+		// после - на имя в пуле строк каталога
+		std::string_view name_;
 		geo::Coordinates coordinates_{ 0L, 0L };
+		StopId id_ = 0U;
 	};
 
+	// Остановки маршрута; при сборке базы размещаются в её арене
+	using StopsList = std::pmr::vector<Stop*>;
+
 	struct Bus {
 		Bus() = default;
 		Bus(Bus* other);
+		explicit Bus(std::pmr::memory_resource* resource);
 
 		Bus& SetBusName(std::string_view Bus_name);
-		Bus& SetStops(std::vector<Stop*>&& stops);
+		Bus& SetStops(StopsList&& stops);
 		Bus& SetBusType(bool type);
 		Bus& SetUniqueStops(size_t stops);
 		Bus& SetGeoRouteLength(double length);
 		Bus& SetRealRouteLength(size_t length);
 		Bus& SetCurvature(double curvature);
 
-		const std::string& GetBusName() const;
-		const std::vector<Stop*>& GetStops() const;
+		std::string_view GetBusName() const;
+		const StopsList& GetStops() const;
+		// Полный проход маршрута: для некольцевого - туда и обратно
+		ranges::RouteRange<StopsList::const_iterator> GetRouteStops() const;
 		bool GetBusType() const;
 		size_t GetUniqueStops() const;
 		double GetGeoRouteLength() const;
 		size_t GetRealRouteLength() const;
 		double GetCurvature() const;
 
-		std::string bus_name_;
-		std::vector<Stop*> stops_;
+		// Как и Stop::name_, после добавления в каталог указывает в пул строк
+		std::string_view bus_name_;
+		// Остановки в порядке задания, обратный ход некольцевого маршрута не хранится
+		StopsList stops_;
 		size_t unique_stops_ = 0U;
 		double geo_route_length_ = 0L;
 		size_t real_route_length_ = 0U;
 		double route_curvature_ = 1L;
 		bool is_circular_ = false;
+		BusId id_ = 0U;
 	};
 
-	using StopsMap = std::unordered_map<std::string_view, Stop*>;
-	using BusesMap = std::unordered_map<std::string_view, Bus*>;
+	// Отсортированный по возрастанию список id маршрутов, проходящих через остановку
+	using BusIdsList = std::vector<BusId>;
 
 	struct StopStat {
-		explicit StopStat(std::string_view name, std::set<std::string_view>& buses);
 		std::string_view stop_name_;
-		std::set<std::string_view> buses_;
+		// Имена маршрутов через остановку по возрастанию, хранятся в каталоге
+		ranges::Range<const std::string_view*> buses_{ nullptr, nullptr };
 	};
 
 	struct BusStat {
 		BusStat() = default;
 		explicit BusStat(std::string_view name, size_t stops,
 			size_t unique_stops, size_t dist, double curvature);
-		std::string bus_name_;
+		std::string_view bus_name_;
 		size_t bus_stops_num_ = 0U;
 		size_t unique_stops_num_ = 0U;
 		size_t route_length_ = 0U;
@@ -84,18 +102,16 @@ namespace domain {
 
 	};
 
-	class PointersPairHasher
-	{
-	public:
-		std::size_t operator()(const std::pair<Stop*, Stop*> pointers) const noexcept;
-	};
-
 	enum RequestType {
 		null = 0,
 		add_stop,
 		add_bus,
 		find_stop,
-		find_bus
+		find_bus,
+		// изменения загруженной базы
+		update_stop_coordinates,
+		set_road_distance,
+		add_stop_to_bus
 	};
 
 	struct EnumClassHash
@@ -107,23 +123,47 @@ namespace domain {
 		}
 	};
 
+	// Строки и контейнеры запроса берут память из ресурса аллокатора, чтобы
+	// при сборке базы весь разбор входа шёл в арену и освобождался разом
 	struct Request {
+		using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+		using Distances = std::pmr::map<std::pmr::string, int64_t>;
+
 		Request() = default;
+		explicit Request(const allocator_type& alloc);
+		Request(const Request& other, const allocator_type& alloc);
+		Request(Request&& other, const allocator_type& alloc);
+		Request(const Request&) = default;
+		Request(Request&&) = default;
+		Request& operator=(const Request&) = default;
+		Request& operator=(Request&&) = default;
 
 		size_t id_ = 0;
 		RequestType type_ = RequestType::null;
-		std::string key_ = ""s;
-		std::string name_ = ""s;
-		std::string from_ = ""s;
-		std::string to_ = ""s;
+		std::pmr::string key_;
+		std::pmr::string name_;
+		std::pmr::string from_;
+		std::pmr::string to_;
 		geo::Coordinates coordinates_ = { 0L, 0L };
-		std::vector<std::string> stops_ = {};
-		std::map<std::string, int64_t> distances_ = {};
+		std::pmr::vector<std::pmr::string> stops_;
+		std::pmr::vector<std::pmr::string> to_any_;
+		std::pmr::string to_bus_;
+		Distances distances_;
 		bool is_circular_ = true;
+		// Место вставки остановки в маршрут; по умолчанию - в конец
+		std::optional<size_t> position_;
+		// Поиск остановок по координатам: coordinates_ - точка или нижний угол прямоугольника
+		size_t count_ = 0U;
+		double radius_ = 0.0;
+		geo::Coordinates max_coordinates_ = { 0L, 0L };
+		// Поиск остановок по началу имени
+		std::pmr::string prefix_;
+		size_t max_edits_ = 0U;
 
 	};
 
-	using RequestsMap = std::unordered_map<RequestType, std::vector<Request>, EnumClassHash>;
+	using RequestsList = std::pmr::vector<Request>;
+	using RequestsMap = std::unordered_map<RequestType, RequestsList, EnumClassHash>;
 
 	struct RouteItem {
 
@@ -143,6 +183,34 @@ namespace domain {
 		graph::EdgeType type_;
 	};
 
+	struct ConnectionItem {
+		std::string_view bus_name_;
+		int span_count_ = 0;
+		size_t route_length_ = 0U;
+	};
+
+	struct ConnectionStat
+	{
+		std::vector<ConnectionItem> connections_;
+		bool is_found_ = false;
+	};
+
+	// Остановка рядом с точкой запроса и расстояние до неё в метрах
+	struct NearbyStop {
+		std::string_view stop_name_;
+		double distance_ = 0.0;
+	};
+
+	using NearbyStopsStat = std::vector<NearbyStop>;
+
+	// Найденная по имени остановка и число обслуживающих её маршрутов
+	struct StopSearchItem {
+		std::string_view stop_name_;
+		size_t bus_count_ = 0U;
+	};
+
+	using StopSearchStat = std::vector<StopSearchItem>;
+
 	struct RouteStat
 	{
 		double total_time_ = 0.0;
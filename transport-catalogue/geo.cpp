@@ -1,7 +1,120 @@
 #include "geo.h"
 
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEO_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace geo {
 
+    namespace {
+
+        constexpr double DEG_TO_RAD = RadToDegCoef;
+
+        // cos((lat1 + lat2) / 2) через cos суммы широт: cos^2(x / 2) = (1 + cos x) / 2
+        double ApproximateDistance(double lat1, double lng1, double sin1, double cos1,
+            double lat2, double lng2, double sin2, double cos2) {
+            const double mean_cos = std::sqrt(std::max(0.0, (1.0 + (cos1 * cos2 - sin1 * sin2)) * 0.5));
+            const double x = (lng1 - lng2) * DEG_TO_RAD * mean_cos;
+            const double y = (lat1 - lat2) * DEG_TO_RAD;
+            return std::sqrt(x * x + y * y) * EarthRadius;
+        }
+
+#ifdef GEO_X86_KERNELS
+        // Векторные версии повторяют ApproximateDistance операция в операцию. Компилятор вправе
+        // слить умножение со сложением в FMA, так что последние биты могут отличаться от скалярной
+        // версии - для фильтра с запасом APPROXIMATE_RELATIVE_ERROR это не важно
+
+        __attribute__((target("avx2")))
+        size_t ApproximateDistancesAvx2(const TrigonometricTable::Point& from, const double* lat, const double* lng,
+            const double* lat_sin, const double* lat_cos, const uint32_t* to, size_t count, double* out) {
+            const __m256d lat1 = _mm256_set1_pd(from.lat);
+            const __m256d lng1 = _mm256_set1_pd(from.lng);
+            const __m256d sin1 = _mm256_set1_pd(from.lat_sin);
+            const __m256d cos1 = _mm256_set1_pd(from.lat_cos);
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d half = _mm256_set1_pd(0.5);
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d coef = _mm256_set1_pd(DEG_TO_RAD);
+            const __m256d radius = _mm256_set1_pd(EarthRadius);
+            // Сбор с маской и нулевым источником: у _mm256_i32gather_pd источник не инициализирован,
+            // и GCC с -Wall предупреждает о нём
+            const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i));
+                const __m256d lat2 = _mm256_mask_i32gather_pd(zero, lat, index, all, 8);
+                const __m256d lng2 = _mm256_mask_i32gather_pd(zero, lng, index, all, 8);
+                const __m256d sin2 = _mm256_mask_i32gather_pd(zero, lat_sin, index, all, 8);
+                const __m256d cos2 = _mm256_mask_i32gather_pd(zero, lat_cos, index, all, 8);
+
+                const __m256d sum_cos = _mm256_sub_pd(_mm256_mul_pd(cos1, cos2), _mm256_mul_pd(sin1, sin2));
+                const __m256d mean_cos = _mm256_sqrt_pd(_mm256_max_pd(zero, _mm256_mul_pd(_mm256_add_pd(one, sum_cos), half)));
+                const __m256d x = _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(lng1, lng2), coef), mean_cos);
+                const __m256d y = _mm256_mul_pd(_mm256_sub_pd(lat1, lat2), coef);
+                const __m256d length = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+                _mm256_storeu_pd(out + i, _mm256_mul_pd(length, radius));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx512f")))
+        size_t ApproximateDistancesAvx512(const TrigonometricTable::Point& from, const double* lat, const double* lng,
+            const double* lat_sin, const double* lat_cos, const uint32_t* to, size_t count, double* out) {
+            const __m512d lat1 = _mm512_set1_pd(from.lat);
+            const __m512d lng1 = _mm512_set1_pd(from.lng);
+            const __m512d sin1 = _mm512_set1_pd(from.lat_sin);
+            const __m512d cos1 = _mm512_set1_pd(from.lat_cos);
+            const __m512d one = _mm512_set1_pd(1.0);
+            const __m512d half = _mm512_set1_pd(0.5);
+            const __m512d zero = _mm512_setzero_pd();
+            const __m512d coef = _mm512_set1_pd(DEG_TO_RAD);
+            const __m512d radius = _mm512_set1_pd(EarthRadius);
+            // Сбор, максимум и корень - в формах с маской: обычные берут неинициализированный
+            // источник (_mm512_undefined_pd), и GCC с -Wall предупреждает о нём
+            const __mmask8 all = 0xFF;
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + i));
+                const __m512d lat2 = _mm512_mask_i32gather_pd(zero, all, index, lat, 8);
+                const __m512d lng2 = _mm512_mask_i32gather_pd(zero, all, index, lng, 8);
+                const __m512d sin2 = _mm512_mask_i32gather_pd(zero, all, index, lat_sin, 8);
+                const __m512d cos2 = _mm512_mask_i32gather_pd(zero, all, index, lat_cos, 8);
+
+                const __m512d sum_cos = _mm512_sub_pd(_mm512_mul_pd(cos1, cos2), _mm512_mul_pd(sin1, sin2));
+                const __m512d mean_cos = _mm512_maskz_sqrt_pd(all, _mm512_maskz_max_pd(all, zero, _mm512_mul_pd(_mm512_add_pd(one, sum_cos), half)));
+                const __m512d x = _mm512_mul_pd(_mm512_mul_pd(_mm512_sub_pd(lng1, lng2), coef), mean_cos);
+                const __m512d y = _mm512_mul_pd(_mm512_sub_pd(lat1, lat2), coef);
+                const __m512d length = _mm512_maskz_sqrt_pd(all, _mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y)));
+                _mm512_storeu_pd(out + i, _mm512_mul_pd(length, radius));
+            }
+            return i;
+        }
+
+        enum class Kernel {
+            scalar,
+            avx2,
+            avx512
+        };
+
+        Kernel DetectKernel() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return Kernel::avx512;
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                return Kernel::avx2;
+            }
+            return Kernel::scalar;
+        }
+#endif
+
+    }  // namespace
+
     Coordinates::Coordinates(double lat, double lng)
         : lat(lat), lng(lng) {
     }
@@ -61,4 +174,96 @@ namespace geo {
             + cos(from.lat * RadToDegCoef) * cos(to.lat * RadToDegCoef) * cos(abs(from.lng - to.lng) * RadToDegCoef))
             * EarthRadius;
     }
+
+    TrigonometricTable::Point TrigonometricTable::MakePoint(Coordinates coordinates) {
+        return {
+            coordinates.lat,
+            coordinates.lng,
+            std::sin(coordinates.lat * RadToDegCoef),
+            std::cos(coordinates.lat * RadToDegCoef)
+        };
+    }
+
+    void TrigonometricTable::Assign(const std::vector<Coordinates>& points) {
+        Clear();
+        lat_.reserve(points.size());
+        lng_.reserve(points.size());
+        lat_sin_.reserve(points.size());
+        lat_cos_.reserve(points.size());
+        for (const Coordinates& point : points) {
+            PushBack(point);
+        }
+    }
+
+    void TrigonometricTable::PushBack(Coordinates coordinates) {
+        const Point point = MakePoint(coordinates);
+        lat_.push_back(point.lat);
+        lng_.push_back(point.lng);
+        lat_sin_.push_back(point.lat_sin);
+        lat_cos_.push_back(point.lat_cos);
+    }
+
+    void TrigonometricTable::Set(size_t index, Coordinates coordinates) {
+        const Point point = MakePoint(coordinates);
+        lat_[index] = point.lat;
+        lng_[index] = point.lng;
+        lat_sin_[index] = point.lat_sin;
+        lat_cos_[index] = point.lat_cos;
+    }
+
+    void TrigonometricTable::Clear() {
+        lat_.clear();
+        lng_.clear();
+        lat_sin_.clear();
+        lat_cos_.clear();
+    }
+
+    double TrigonometricTable::ComputeDistance(const Point& from, size_t to) const {
+        using namespace std;
+        if (from.lat == lat_[to] && from.lng == lng_[to]) {
+            return 0;
+        }
+        return acos(from.lat_sin * lat_sin_[to]
+            + from.lat_cos * lat_cos_[to] * cos(abs(from.lng - lng_[to]) * RadToDegCoef))
+            * EarthRadius;
+    }
+
+    void TrigonometricTable::ComputeDistances(const uint32_t* from, const uint32_t* to, size_t count, double* out) const {
+        for (size_t i = 0; i != count; ++i) {
+            out[i] = ComputeDistance(from[i], to[i]);
+        }
+    }
+
+    void TrigonometricTable::ComputeApproximateDistances(size_t from, const uint32_t* to, size_t count, double* out) const {
+        const Point point = GetPoint(from);
+        size_t done = 0;
+#ifdef GEO_X86_KERNELS
+        static const Kernel kernel = DetectKernel();
+        if (kernel == Kernel::avx512) {
+            done = ApproximateDistancesAvx512(point, lat_.data(), lng_.data(), lat_sin_.data(), lat_cos_.data(), to, count, out);
+        }
+        else if (kernel == Kernel::avx2) {
+            done = ApproximateDistancesAvx2(point, lat_.data(), lng_.data(), lat_sin_.data(), lat_cos_.data(), to, count, out);
+        }
+#endif
+        // Хвост пачки и процессоры без векторных расширений
+        for (size_t i = done; i != count; ++i) {
+            out[i] = ApproximateDistance(point.lat, point.lng, point.lat_sin, point.lat_cos,
+                lat_[to[i]], lng_[to[i]], lat_sin_[to[i]], lat_cos_[to[i]]);
+        }
+    }
+
+    QuantizedCoordinates Quantize(Coordinates coordinates) {
+        return {
+            static_cast<int32_t>(std::lround(coordinates.lat * QUANTIZATION_SCALE)),
+            static_cast<int32_t>(std::lround(coordinates.lng * QUANTIZATION_SCALE))
+        };
+    }
+
+    Coordinates Dequantize(QuantizedCoordinates coordinates) {
+        return {
+            coordinates.lat / QUANTIZATION_SCALE,
+            coordinates.lng / QUANTIZATION_SCALE
+        };
+    }
 }
\ No newline at end of file
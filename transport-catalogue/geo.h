@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 constexpr double RadToDegCoef = 3.1415926535 / 180.;
 constexpr int EarthRadius = 6371000;
@@ -35,4 +37,87 @@ namespace geo {
     };
 
     double ComputeDistance(Coordinates from, Coordinates to);
+
+    // Координаты набора точек раздельными массивами вместе с синусом и косинусом широты,
+    // посчитанными один раз при записи точки. Расстояние до точки таблицы стоит одного cos
+    // и одного acos вместо шести тригонометрических вызовов ComputeDistance
+    class TrigonometricTable {
+    public:
+        // Точка вне таблицы с посчитанной тригонометрией - начало серии расстояний
+        struct Point {
+            double lat = 0.0;
+            double lng = 0.0;
+            double lat_sin = 0.0;
+            double lat_cos = 1.0;
+        };
+
+        // Погрешность приближённого расстояния для точек не дальше APPROXIMATE_MAX_DISTANCE
+        // друг от друга и не ближе к полюсу, чем APPROXIMATE_MAX_LATITUDE: |d' - d| <= d * RELATIVE + ABSOLUTE.
+        // Взята с запасом: на случайных парах относительная ошибка не превышает 0.3%, абсолютная
+        // часть покрывает погрешность acos точной формулы на малых углах
+        static constexpr double APPROXIMATE_RELATIVE_ERROR = 0.01;
+        static constexpr double APPROXIMATE_ABSOLUTE_ERROR = 1.0;
+        static constexpr double APPROXIMATE_MAX_DISTANCE = 100000.0;
+        static constexpr double APPROXIMATE_MAX_LATITUDE = 85.0;
+
+        static Point MakePoint(Coordinates coordinates);
+
+        void Assign(const std::vector<Coordinates>& points);
+        void PushBack(Coordinates coordinates);
+        void Set(size_t index, Coordinates coordinates);
+        void Clear();
+
+        Point GetPoint(size_t index) const {
+            return { lat_[index], lng_[index], lat_sin_[index], lat_cos_[index] };
+        }
+
+        Coordinates Get(size_t index) const {
+            return { lat_[index], lng_[index] };
+        }
+
+        size_t size() const {
+            return lat_.size();
+        }
+
+        // Совпадают с ComputeDistance до бита: те же выражения над теми же значениями
+        double ComputeDistance(const Point& from, size_t to) const;
+        double ComputeDistance(size_t from, size_t to) const {
+            return ComputeDistance(GetPoint(from), to);
+        }
+        // out[i] - расстояние между точками from[i] и to[i]
+        void ComputeDistances(const uint32_t* from, const uint32_t* to, size_t count, double* out) const;
+
+        // Равнопромежуточная проекция около средней широты: без тригонометрии, по одному sqrt
+        // на косинус средней широты и на длину. Годится как фильтр перед точным расчётом.
+        // out[i] - приближённое расстояние от from до to[i]; на x86 считается AVX-512 или AVX2,
+        // если их поддерживает процессор
+        void ComputeApproximateDistances(size_t from, const uint32_t* to, size_t count, double* out) const;
+
+    private:
+        std::vector<double> lat_;
+        std::vector<double> lng_;
+        std::vector<double> lat_sin_;
+        std::vector<double> lat_cos_;
+    };
+
+    // Координаты с фиксированной точкой в микроградусах: 8 байт вместо 16 у Coordinates.
+    // Округление сдвигает точку не более чем на полшага 0.5e-6 градуса, то есть
+    // на ~5.6 см по каждой оси, и расстояние между двумя точками - не более чем на MAX_QUANTIZATION_ERROR
+    struct QuantizedCoordinates {
+        int32_t lat = 0;
+        int32_t lng = 0;
+
+        bool operator==(const QuantizedCoordinates& other) const {
+            return lat == other.lat && lng == other.lng;
+        }
+    };
+
+    constexpr double QUANTIZATION_SCALE = 1e6;
+    // Два конца отрезка, каждый смещён не более чем на полшага по обеим осям, в метрах.
+    // Для точек ближе метра к ней добавляется погрешность acos в ComputeDistance (до ~6 см).
+    // Проверяется tests/geo_test.cpp
+    constexpr double MAX_QUANTIZATION_ERROR = 2 * 1.4142135624 * 0.5 / QUANTIZATION_SCALE * RadToDegCoef * EarthRadius;
+
+    QuantizedCoordinates Quantize(Coordinates coordinates);
+    Coordinates Dequantize(QuantizedCoordinates coordinates);
 }
\ No newline at end of file
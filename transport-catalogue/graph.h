@@ -3,6 +3,8 @@
 #include "ranges.h"
 
 #include <cstdlib>
+#include <memory_resource>
+#include <string_view>
 #include <vector>
 
 namespace graph {
@@ -10,8 +12,9 @@ namespace graph {
     using VertexId = size_t;
     using EdgeId = size_t;
 
+    // wait - ожидание на остановке, move - поездка на автобусе, walk - пешая пересадка
     enum EdgeType {
-        wait, move
+        wait, move, walk
     };
 
     template <typename Weight>
@@ -33,8 +36,8 @@ namespace graph {
             weight = w;
             return *this;
         }
-        Edge& SetEdgeName(std::string name) {
-            edge_name = std::move(name);
+        Edge& SetEdgeName(std::string_view name) {
+            edge_name = name;
             return *this;
         }
         Edge& SetEdgeSpanCount(int count) {
@@ -65,34 +68,41 @@ namespace graph {
         VertexId from;
         VertexId to;
         Weight weight;
-        std::string edge_name = {};
+        // Имя остановки или маршрута из пула строк каталога
+        std::string_view edge_name = {};
         int span_count = 0;
     };
 
     template <typename Weight>
     class DirectedWeightedGraph {
     private:
-        using IncidenceList = std::vector<EdgeId>;
+        using IncidenceList = std::pmr::vector<EdgeId>;
         using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
 
     public:
         DirectedWeightedGraph() = default;
-        explicit DirectedWeightedGraph(size_t vertex_count);
+        // Рёбра и списки смежности размещаются в resource: при сборке базы это арена
+        explicit DirectedWeightedGraph(size_t vertex_count,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         EdgeId AddEdge(const Edge<Weight>& edge);
 
+        // Резервирование заранее не даёт арене копить брошенные при росте буферы
+        void ReserveEdges(size_t edge_count);
+        void ReserveIncidentEdges(VertexId vertex, size_t edge_count);
+
         size_t GetVertexCount() const;
         size_t GetEdgeCount() const;
         const Edge<Weight>& GetEdge(EdgeId edge_id) const;
         IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
 
     private:
-        std::vector<Edge<Weight>> edges_;
-        std::vector<IncidenceList> incidence_lists_;
+        std::pmr::vector<Edge<Weight>> edges_;
+        std::pmr::vector<IncidenceList> incidence_lists_;
     };
 
     template <typename Weight>
-    DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-        : incidence_lists_(vertex_count) {
+    DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count, std::pmr::memory_resource* resource)
+        : edges_(resource), incidence_lists_(vertex_count, resource) {
     }
 
     template <typename Weight>
@@ -103,6 +113,16 @@ namespace graph {
         return id;
     }
 
+    template <typename Weight>
+    void DirectedWeightedGraph<Weight>::ReserveEdges(size_t edge_count) {
+        edges_.reserve(edge_count);
+    }
+
+    template <typename Weight>
+    void DirectedWeightedGraph<Weight>::ReserveIncidentEdges(VertexId vertex, size_t edge_count) {
+        incidence_lists_.at(vertex).reserve(edge_count);
+    }
+
     template <typename Weight>
     size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
         return incidence_lists_.size();
@@ -0,0 +1,238 @@
+#include "huge_page_allocator.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std::literals;
+
+namespace memory {
+
+    namespace {
+
+        struct MappedRegion {
+            void* base = nullptr;
+            size_t size = 0U;
+            bool hugetlb = false;
+            bool advised = false;
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::unordered_map<void*, MappedRegion> regions;
+            HugePageCounters counters;
+        };
+
+        Registry& GetRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        size_t RoundUp(size_t bytes, size_t alignment) {
+            return (bytes + alignment - 1) / alignment * alignment;
+        }
+
+#ifdef __linux__
+        std::optional<MappedRegion> MapHugeTlb(size_t bytes) {
+#ifdef MAP_HUGETLB
+            const size_t size = RoundUp(bytes, HUGE_PAGE_SIZE);
+            void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                return MappedRegion{ ptr, size, true, false };
+            }
+#endif
+            // пул hugetlbfs не настроен или исчерпан
+            (void)bytes;
+            return std::nullopt;
+        }
+
+        std::optional<MappedRegion> MapTransparent(size_t bytes) {
+            const size_t size = RoundUp(bytes, HUGE_PAGE_SIZE);
+            // отображаем с запасом, чтобы выровнять начало по границе huge-страницы
+            const size_t reserve = size + HUGE_PAGE_SIZE;
+            void* raw = mmap(nullptr, reserve, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                return std::nullopt;
+            }
+
+            const auto raw_addr = reinterpret_cast<uintptr_t>(raw);
+            const uintptr_t aligned_addr = RoundUp(raw_addr, HUGE_PAGE_SIZE);
+            const size_t head = aligned_addr - raw_addr;
+            const size_t tail = reserve - head - size;
+            if (head != 0U) {
+                munmap(raw, head);
+            }
+            if (tail != 0U) {
+                munmap(reinterpret_cast<void*>(aligned_addr + size), tail);
+            }
+
+            void* ptr = reinterpret_cast<void*>(aligned_addr);
+            bool advised = false;
+#ifdef MADV_HUGEPAGE
+            advised = madvise(ptr, size, MADV_HUGEPAGE) == 0;
+#endif
+            return MappedRegion{ ptr, size, false, advised };
+        }
+
+        size_t ReadAnonHugeBytes(const std::unordered_map<void*, MappedRegion>& regions) {
+            std::ifstream smaps("/proc/self/smaps"s);
+            if (!smaps) {
+                return 0U;
+            }
+
+            size_t result = 0U;
+            bool inside = false;
+            std::string line;
+            while (std::getline(smaps, line)) {
+                uintptr_t start = 0, end = 0;
+                char dash = 0;
+                std::istringstream header(line);
+                if (header >> std::hex >> start >> dash >> end && dash == '-') {
+                    // заголовок очередного отображения
+                    inside = false;
+                    for (const auto& [ptr, region] : regions) {
+                        const auto base = reinterpret_cast<uintptr_t>(region.base);
+                        if (!region.hugetlb && start < base + region.size && base < end) {
+                            inside = true;
+                            break;
+                        }
+                    }
+                }
+                else if (inside && line.rfind("AnonHugePages:"s, 0) == 0) {
+                    std::istringstream field(line.substr(14));
+                    size_t kb = 0;
+                    field >> kb;
+                    result += kb * 1024U;
+                }
+            }
+            return result;
+        }
+#endif
+
+    }  // namespace
+
+    HugePagePolicy ParseHugePagePolicy(std::string_view name) {
+        if (name == "none"sv) {
+            return HugePagePolicy::none;
+        }
+        if (name == "hugetlb"sv) {
+            return HugePagePolicy::hugetlb;
+        }
+        if (name == "transparent"sv) {
+            return HugePagePolicy::transparent;
+        }
+        throw std::invalid_argument("Unknown huge page policy "s + std::string(name));
+    }
+
+    std::string_view HugePagePolicyName(HugePagePolicy policy) {
+        switch (policy)
+        {
+        case HugePagePolicy::none:
+            return "none"sv;
+        case HugePagePolicy::hugetlb:
+            return "hugetlb"sv;
+        default:
+            return "transparent"sv;
+        }
+    }
+
+    void* AllocateLarge(size_t bytes, HugePagePolicy policy) {
+        if (policy == HugePagePolicy::none || bytes < LARGE_ALLOCATION_THRESHOLD) {
+            return ::operator new(bytes);
+        }
+
+        std::optional<MappedRegion> region;
+#ifdef __linux__
+        if (policy == HugePagePolicy::hugetlb) {
+            region = MapHugeTlb(bytes);
+        }
+        if (!region) {
+            region = MapTransparent(bytes);
+        }
+#endif
+
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+
+        if (!region) {
+            ++registry.counters.fallback_allocations;
+            return ::operator new(bytes);
+        }
+
+        ++registry.counters.large_allocations;
+        registry.counters.mapped_bytes += region->size;
+        if (region->hugetlb) {
+            ++registry.counters.hugetlb_allocations;
+            registry.counters.hugetlb_bytes += region->size;
+        }
+        if (region->advised) {
+            registry.counters.advised_bytes += region->size;
+        }
+        registry.regions.insert({ region->base, *region });
+        return region->base;
+    }
+
+    void DeallocateLarge(void* ptr, size_t bytes) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        Registry& registry = GetRegistry();
+        {
+            std::lock_guard guard(registry.mutex);
+            auto it = registry.regions.find(ptr);
+            if (it != registry.regions.end()) {
+                const MappedRegion region = it->second;
+                registry.regions.erase(it);
+
+                registry.counters.mapped_bytes -= region.size;
+                if (region.hugetlb) {
+                    registry.counters.hugetlb_bytes -= region.size;
+                }
+                if (region.advised) {
+                    registry.counters.advised_bytes -= region.size;
+                }
+#ifdef __linux__
+                munmap(region.base, region.size);
+#endif
+                return;
+            }
+        }
+        ::operator delete(ptr, bytes);
+    }
+
+    HugePageCounters GetHugePageCounters(bool refresh_resident) {
+        Registry& registry = GetRegistry();
+        std::lock_guard guard(registry.mutex);
+#ifdef __linux__
+        if (refresh_resident) {
+            registry.counters.anon_huge_bytes = ReadAnonHugeBytes(registry.regions);
+        }
+#else
+        (void)refresh_resident;
+#endif
+        return registry.counters;
+    }
+
+    void PrintHugePageCounters(std::ostream& out, const HugePageCounters& counters) {
+        out << "huge pages: large_allocations="sv << counters.large_allocations
+            << " hugetlb_allocations="sv << counters.hugetlb_allocations
+            << " fallback_allocations="sv << counters.fallback_allocations
+            << " mapped_bytes="sv << counters.mapped_bytes
+            << " hugetlb_bytes="sv << counters.hugetlb_bytes
+            << " advised_bytes="sv << counters.advised_bytes
+            << " anon_huge_bytes="sv << counters.anon_huge_bytes << '\n';
+    }
+
+}  // namespace memory
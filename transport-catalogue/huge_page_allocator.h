@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <string_view>
+
+namespace memory {
+
+    // Размер huge-страницы, под который выравниваются крупные отображения
+    constexpr size_t HUGE_PAGE_SIZE = 2U * 1024U * 1024U;
+    // Выделения меньше этого порога обслуживаются обычным operator new
+    constexpr size_t LARGE_ALLOCATION_THRESHOLD = HUGE_PAGE_SIZE;
+
+    enum class HugePagePolicy {
+        none,           // обычная куча
+        transparent,    // mmap + madvise(MADV_HUGEPAGE)
+        hugetlb         // mmap(MAP_HUGETLB), при неудаче - transparent
+    };
+
+    // std::invalid_argument для имени, отличного от "none", "transparent" и "hugetlb"
+    HugePagePolicy ParseHugePagePolicy(std::string_view name);
+    std::string_view HugePagePolicyName(HugePagePolicy policy);
+
+    struct HugePageCounters {
+        size_t large_allocations = 0U;      // выделения через mmap
+        size_t hugetlb_allocations = 0U;    // из них получено из hugetlbfs
+        size_t fallback_allocations = 0U;   // откат на обычную кучу
+        size_t mapped_bytes = 0U;           // байт отображено сейчас
+        size_t hugetlb_bytes = 0U;          // байт из hugetlbfs сейчас
+        size_t advised_bytes = 0U;          // байт с MADV_HUGEPAGE сейчас
+        size_t anon_huge_bytes = 0U;        // AnonHugePages по /proc/self/smaps на момент обновления
+    };
+
+    void* AllocateLarge(size_t bytes, HugePagePolicy policy);
+    void DeallocateLarge(void* ptr, size_t bytes) noexcept;
+
+    // Перечитывает фактическое покрытие huge-страницами у живых отображений
+    HugePageCounters GetHugePageCounters(bool refresh_resident = true);
+    void PrintHugePageCounters(std::ostream& out, const HugePageCounters& counters);
+
+    template <typename T>
+    class HugePageAllocator {
+    public:
+        using value_type = T;
+
+        HugePageAllocator() noexcept = default;
+        explicit HugePageAllocator(HugePagePolicy policy) noexcept
+            : policy_(policy) {
+        }
+
+        template <typename U>
+        HugePageAllocator(const HugePageAllocator<U>& other) noexcept
+            : policy_(other.GetPolicy()) {
+        }
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(AllocateLarge(n * sizeof(T), policy_));
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept {
+            DeallocateLarge(ptr, n * sizeof(T));
+        }
+
+        HugePagePolicy GetPolicy() const noexcept {
+            return policy_;
+        }
+
+        template <typename U>
+        bool operator==(const HugePageAllocator<U>&) const noexcept {
+            // любая память освобождается любым экземпляром
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const HugePageAllocator<U>& other) const noexcept {
+            return !(*this == other);
+        }
+
+    private:
+        HugePagePolicy policy_ = HugePagePolicy::transparent;
+    };
+
+}  // namespace memory
@@ -0,0 +1,83 @@
+#include "input_buffer.h"
+
+#include <fstream>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+    InputBuffer::~InputBuffer() {
+        Reset();
+    }
+
+    InputBuffer::InputBuffer(InputBuffer&& other) noexcept
+        : mapped_(std::exchange(other.mapped_, nullptr))
+        , size_(std::exchange(other.size_, 0U))
+        , data_(std::move(other.data_)) {
+    }
+
+    InputBuffer& InputBuffer::operator=(InputBuffer&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            mapped_ = std::exchange(other.mapped_, nullptr);
+            size_ = std::exchange(other.size_, 0U);
+            data_ = std::move(other.data_);
+        }
+        return *this;
+    }
+
+    void InputBuffer::Reset() noexcept {
+#ifdef __linux__
+        if (mapped_ != nullptr) {
+            munmap(mapped_, size_);
+        }
+#endif
+        mapped_ = nullptr;
+        size_ = 0U;
+        data_.clear();
+    }
+
+    InputBuffer InputBuffer::Open(const std::string& path) {
+        InputBuffer result;
+#ifdef __linux__
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat info {};
+            // Пустой файл не отображается, а не обычные файлы (каналы) читаются потоком
+            if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+                const size_t size = static_cast<size_t>(info.st_size);
+                void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (ptr != MAP_FAILED) {
+                    // Разбор читает файл один раз от начала к концу
+                    madvise(ptr, size, MADV_SEQUENTIAL);
+                    result.mapped_ = ptr;
+                    result.size_ = size;
+                }
+            }
+            close(fd);
+            if (result.mapped_ != nullptr) {
+                return result;
+            }
+        }
+#endif
+        std::ifstream input(path, std::ios::binary);
+        return Read(input);
+    }
+
+    InputBuffer InputBuffer::Read(std::istream& input) {
+        InputBuffer result;
+        // Поток может не поддерживать позиционирование, поэтому размер заранее не известен
+        char chunk[1 << 16];
+        while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+            result.data_.append(chunk, static_cast<size_t>(input.gcount()));
+        }
+        return result;
+    }
+
+}  // namespace io
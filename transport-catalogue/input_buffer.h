@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+    // Входной файл целиком в непрерывной памяти. На Linux файл отображается через mmap
+    // и страницы подгружаются по мере чтения; если отобразить не удалось - читается в строку.
+    // Разбор JSON идёт прямо по буферу, поэтому буфер должен жить, пока нужен документ
+    // со ссылками в него
+    class InputBuffer {
+    public:
+        InputBuffer() = default;
+        ~InputBuffer();
+
+        InputBuffer(const InputBuffer&) = delete;
+        InputBuffer& operator=(const InputBuffer&) = delete;
+        InputBuffer(InputBuffer&& other) noexcept;
+        InputBuffer& operator=(InputBuffer&& other) noexcept;
+
+        // Несуществующий или нечитаемый файл даёт пустой буфер
+        static InputBuffer Open(const std::string& path);
+        static InputBuffer Read(std::istream& input);
+
+        std::string_view View() const {
+            return mapped_ != nullptr ? std::string_view(static_cast<const char*>(mapped_), size_) : std::string_view(data_);
+        }
+
+        bool IsMapped() const {
+            return mapped_ != nullptr;
+        }
+
+    private:
+        void Reset() noexcept;
+
+        void* mapped_ = nullptr;
+        size_t size_ = 0U;
+        std::string data_;
+    };
+
+}  // namespace io
@@ -0,0 +1,105 @@
+#include "intersection.h"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace intersection {
+
+    void Intersect(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs, std::vector<uint32_t>& out) {
+        if (lhs.empty() || rhs.empty()) {
+            return;
+        }
+        // Диапазоны не пересекаются - сравнивать нечего
+        if (lhs.back() < rhs.front() || rhs.back() < lhs.front()) {
+            return;
+        }
+
+        const std::vector<uint32_t>& small = lhs.size() <= rhs.size() ? lhs : rhs;
+        const std::vector<uint32_t>& large = lhs.size() <= rhs.size() ? rhs : lhs;
+
+        if (small.size() * GALLOPING_RATIO < large.size()) {
+            IntersectGalloping(small.data(), small.size(), large.data(), large.size(), out);
+        }
+        else {
+            IntersectMerge(lhs.data(), lhs.size(), rhs.data(), rhs.size(), out);
+        }
+    }
+
+    void IntersectMerge(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, std::vector<uint32_t>& out) {
+        size_t i = 0;
+        size_t j = 0;
+
+#ifdef __SSE2__
+        // Блоки по 4 элемента сравниваются "все со всеми" за 4 сравнения с циклическим сдвигом
+        while (i + 4 <= lhs_size && j + 4 <= rhs_size) {
+            const __m128i lhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+            __m128i rhs_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + j));
+
+            __m128i matches = _mm_cmpeq_epi32(lhs_block, rhs_block);
+            rhs_block = _mm_shuffle_epi32(rhs_block, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(lhs_block, rhs_block));
+            rhs_block = _mm_shuffle_epi32(rhs_block, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(lhs_block, rhs_block));
+            rhs_block = _mm_shuffle_epi32(rhs_block, _MM_SHUFFLE(0, 3, 2, 1));
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi32(lhs_block, rhs_block));
+
+            const int mask = _mm_movemask_ps(_mm_castsi128_ps(matches));
+            for (int k = 0; k < 4; ++k) {
+                if (mask & (1 << k)) {
+                    out.push_back(lhs[i + k]);
+                }
+            }
+
+            // Сдвигаем блок с меньшим максимумом: его элементы больше ни с чем не совпадут
+            const uint32_t lhs_max = lhs[i + 3];
+            const uint32_t rhs_max = rhs[j + 3];
+            if (lhs_max <= rhs_max) {
+                i += 4;
+            }
+            if (rhs_max <= lhs_max) {
+                j += 4;
+            }
+        }
+#endif
+
+        while (i < lhs_size && j < rhs_size) {
+            if (lhs[i] < rhs[j]) {
+                ++i;
+            }
+            else if (rhs[j] < lhs[i]) {
+                ++j;
+            }
+            else {
+                out.push_back(lhs[i]);
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+    void IntersectGalloping(const uint32_t* small, size_t small_size, const uint32_t* large, size_t large_size, std::vector<uint32_t>& out) {
+        size_t pos = 0;
+        for (size_t i = 0; i < small_size && pos < large_size; ++i) {
+            const uint32_t value = small[i];
+
+            // Экспоненциально увеличиваем шаг, пока не перешагнём искомое значение
+            size_t bound = 1;
+            while (pos + bound < large_size && large[pos + bound] < value) {
+                bound *= 2;
+            }
+            const uint32_t* first = large + pos + bound / 2;
+            const uint32_t* last = large + std::min(large_size, pos + bound + 1);
+            const uint32_t* found = std::lower_bound(first, last, value);
+
+            pos = static_cast<size_t>(found - large);
+            if (pos < large_size && large[pos] == value) {
+                out.push_back(value);
+                ++pos;
+            }
+        }
+    }
+
+}  // namespace intersection
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace intersection {
+
+    // Если один список длиннее другого в столько раз, пересечение ищется
+    // галопирующим поиском элементов короткого списка в длинном
+    constexpr size_t GALLOPING_RATIO = 32U;
+
+    // Пересечение двух отсортированных по возрастанию списков без повторов.
+    // Результат дописывается в out в порядке возрастания
+    void Intersect(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs, std::vector<uint32_t>& out);
+
+    void IntersectMerge(const uint32_t* lhs, size_t lhs_size, const uint32_t* rhs, size_t rhs_size, std::vector<uint32_t>& out);
+    void IntersectGalloping(const uint32_t* small, size_t small_size, const uint32_t* large, size_t large_size, std::vector<uint32_t>& out);
+
+}  // namespace intersection
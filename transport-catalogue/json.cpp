@@ -1,4 +1,15 @@
 #include "json.h"
+#include "input_buffer.h"
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__SSE2__)
+#define JSON_SSE2_SCANNER
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -8,270 +19,627 @@ namespace json {
 
         using Number = std::variant<int, double>;
 
-        Node LoadNode(istream& input);
-
-        Number NumericParser(std::istream& input) {
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
 
-            std::string parsed_num;
+        bool IsDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
 
-            // Считывает в parsed_num очередной символ из input
-            auto read_char = [&parsed_num, &input] {
-                parsed_num += static_cast<char>(input.get());
-                if (!input) {
-                    throw ParsingError("Failed to read number from stream"s);
-                }
-                };
+        // Номер младшего установленного бита; bits не равно нулю
+        size_t CountTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_ctzll(bits));
+#else
+            size_t count = 0;
+            for (; (bits & 1U) == 0; bits >>= 1) {
+                ++count;
+            }
+            return count;
+#endif
+        }
 
-            // Считывает одну или более цифр в parsed_num из input
-            auto read_digits = [&input, read_char] {
-                if (!std::isdigit(input.peek())) {
-                    throw ParsingError("A digit is expected"s);
+        // Первый символ, на котором кончается быстрый просмотр строки: '"', '\\', '\n' или '\r'; end, если их нет
+        const char* FindStringSpecial(const char* pos, const char* end) {
+#ifdef JSON_SSE2_SCANNER
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i line_feed = _mm_set1_epi8('\n');
+            const __m128i carriage_return = _mm_set1_epi8('\r');
+            for (; end - pos >= 16; pos += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+                const __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return)));
+                const int mask = _mm_movemask_epi8(special);
+                if (mask != 0) {
+                    return pos + CountTrailingZeros(static_cast<uint32_t>(mask));
                 }
-                while (std::isdigit(input.peek())) {
-                    read_char();
-                }
-                };
-
-            if (input.peek() == '-') {
-                read_char();
             }
-            // Парсим целую часть числа
-            if (input.peek() == '0') {
-                read_char();
-                // После 0 в JSON не могут идти другие цифры
-            }
-            else {
-                read_digits();
+#endif
+            while (pos != end && *pos != '"' && *pos != '\\' && *pos != '\n' && *pos != '\r') {
+                ++pos;
             }
+            return pos;
+        }
 
-            bool is_int = true;
-            // Парсим дробную часть числа
-            if (input.peek() == '.') {
-                read_char();
-                read_digits();
-                is_int = false;
+        // Первый этап разбора в духе simdjson: блок из BLOCK_SIZE байт раскладывается
+        // в битовые маски, бит i отвечает байту block[i]
+        constexpr size_t BLOCK_SIZE = 64U;
+
+        struct BlockMasks {
+            uint64_t quote = 0U;
+            uint64_t backslash = 0U;
+            // '[' и '{'
+            uint64_t open = 0U;
+            // ']' и '}'
+            uint64_t close = 0U;
+        };
+
+        BlockMasks ClassifyBlock(const char* block) {
+            BlockMasks masks;
+#ifdef JSON_SSE2_SCANNER
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            // Квадратная и фигурная скобки отличаются только битом 0x20
+            const __m128i case_bit = _mm_set1_epi8(0x20);
+            const __m128i open = _mm_set1_epi8('{');
+            const __m128i close = _mm_set1_epi8('}');
+            auto to_bits = [](__m128i matches, size_t shift) {
+                return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(matches))) << shift;
+            };
+            for (size_t i = 0; i != BLOCK_SIZE; i += 16) {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+                const __m128i folded = _mm_or_si128(chunk, case_bit);
+                masks.quote |= to_bits(_mm_cmpeq_epi8(chunk, quote), i);
+                masks.backslash |= to_bits(_mm_cmpeq_epi8(chunk, backslash), i);
+                masks.open |= to_bits(_mm_cmpeq_epi8(folded, open), i);
+                masks.close |= to_bits(_mm_cmpeq_epi8(folded, close), i);
             }
-
-            // Парсим экспоненциальную часть числа
-            if (int ch = input.peek(); ch == 'e' || ch == 'E') {
-                read_char();
-                if (ch = input.peek(); ch == '+' || ch == '-') {
-                    read_char();
-                }
-                read_digits();
-                is_int = false;
-            }
-
-            try {
-                if (is_int) {
-                    // Сначала пробуем преобразовать строку в int
-                    try {
-                        return std::stoi(parsed_num);
-                    }
-                    catch (...) {
-                        // В случае неудачи, например, при переполнении,
-                        // код ниже попробует преобразовать строку в double
-                    }
+#else
+            for (size_t i = 0; i != BLOCK_SIZE; ++i) {
+                const uint64_t bit = uint64_t{ 1 } << i;
+                switch (block[i]) {
+                case '"':
+                    masks.quote |= bit;
+                    break;
+                case '\\':
+                    masks.backslash |= bit;
+                    break;
+                case '[':
+                case '{':
+                    masks.open |= bit;
+                    break;
+                case ']':
+                case '}':
+                    masks.close |= bit;
+                    break;
+                default:
+                    break;
                 }
-                return std::stod(parsed_num);
-            }
-            catch (...) {
-                throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
             }
+#endif
+            return masks;
         }
 
-        std::string ProcessSpecialWords(std::istream& input) {
-            std::string result;
-            while (std::isalpha(input.peek()))
-            {
-                result.push_back(static_cast<char>(input.get()));
+        // Экранированные символы блока. escaped_carry на входе - экранирован ли первый байт блока,
+        // на выходе - первый байт следующего. Обратные косые черты редки и перебираются по одной
+        uint64_t EscapedMask(uint64_t backslash, bool& escaped_carry) {
+            uint64_t escaped = escaped_carry ? 1U : 0U;
+            escaped_carry = false;
+            backslash &= ~escaped;
+            while (backslash != 0) {
+                const uint64_t lowest = backslash & (~backslash + 1U);
+                if (lowest == uint64_t{ 1 } << 63) {
+                    escaped_carry = true;
+                }
+                escaped |= lowest << 1;
+                // Экранированная обратная косая черта сама ничего не экранирует
+                backslash &= ~(lowest | lowest << 1);
             }
-            return result;
+            return escaped;
         }
 
-        std::string StringParser(std::istream& input) {
-            using namespace std::literals;
+        // Бит i результата - xor битов 0..i. Для маски неэкранированных кавычек это маска строк
+        // вместе с открывающими кавычками
+        uint64_t PrefixXor(uint64_t bits) {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+            return bits;
+        }
 
-            auto it = std::istreambuf_iterator<char>(input);
-            auto end = std::istreambuf_iterator<char>();
-            std::string s;
-            while (true) {
-                if (it == end) {
-                    // Поток закончился до того, как встретили закрывающую кавычку?
-                    throw ParsingError("String parsing error");
-                }
-                const char ch = *it;
-                if (ch == '"') {
-                    // Встретили закрывающую кавычку
-                    ++it;
-                    break;
-                }
-                else if (ch == '\\') {
-                    // Встретили начало escape-последовательности
-                    ++it;
-                    if (it == end) {
-                        // Поток завершился сразу после символа обратной косой черты
-                        throw ParsingError("String parsing error");
-                    }
-                    const char escaped_char = *(it);
-                    // Обрабатываем одну из последовательностей: \\, \n, \t, \r, \"
-                    switch (escaped_char) {
-                    case 'n':
-                        s.push_back('\n');
-                        break;
-                    case 't':
-                        s.push_back('\t');
-                        break;
-                    case 'r':
-                        s.push_back('\r');
-                        break;
-                    case '"':
-                        s.push_back('"');
-                        break;
-                    case '\\':
-                        s.push_back('\\');
-                        break;
-                    default:
-                        // Встретили неизвестную escape-последовательность
-                        throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
-                    }
-                }
-                else if (ch == '\n' || ch == '\r') {
-                    // Строковый литерал внутри- JSON не может прерываться символами \r или \n
-                    throw ParsingError("Unexpected end of line"s);
-                }
-                else {
-                    // Просто считываем очередной символ и помещаем его в результирующую строку
-                    s.push_back(ch);
-                }
-                ++it;
+    }  // namespace
+
+    Parser::Parser(std::string_view text)
+        : pos_(text.data())
+        , end_(text.data() + text.size()) {
+    }
+
+    Node Parser::ParseNode() {
+        SkipSpaces();
+        if (pos_ == end_) {
+            throw ParsingError("Zero input_stream"s);
+        }
+
+        switch (*pos_)
+        {
+        case '[':
+            ++pos_;
+            return ParseArray();
+
+        case '{':
+            ++pos_;
+            return ParseDict();
+
+        case '"':
+            ++pos_;
+            return Node(std::string(ParseString()));
+
+        case 'n':
+            ExpectWord("null"sv);
+            return Node(nullptr);
+
+        case 't':
+            ExpectWord("true"sv);
+            return Node(true);
+
+        case 'f':
+            ExpectWord("false"sv);
+            return Node(false);
+
+        default:
+            return std::visit([](auto value) {
+                return Node(value);
+                }, ParseNumber());
+        }
+    }
+
+    void Parser::SkipSpaces() {
+        while (pos_ != end_ && IsSpace(*pos_)) {
+            ++pos_;
+        }
+    }
+
+    char Parser::PeekSignificant() {
+        SkipSpaces();
+        return pos_ != end_ ? *pos_ : '\0';
+    }
+
+    void Parser::ExpectEnd() {
+        SkipSpaces();
+        if (pos_ != end_) {
+            throw ParsingError("Unexpected characters after the root value"s);
+        }
+    }
+
+    void Parser::ExpectWord(std::string_view word) {
+        const std::string_view rest(pos_, end_ - pos_);
+        if (rest.substr(0, word.size()) != word
+            || (rest.size() > word.size() && std::isalpha(static_cast<unsigned char>(rest[word.size()])))) {
+            throw ParsingError("Unexpected literal, expected "s + std::string(word));
+        }
+        pos_ += word.size();
+    }
+
+    Number Parser::ParseNumber() {
+        const char* start = pos_;
+
+        // Одна или более цифр
+        auto read_digits = [this] {
+            if (pos_ == end_ || !IsDigit(*pos_)) {
+                throw ParsingError("A digit is expected"s);
             }
+            while (pos_ != end_ && IsDigit(*pos_)) {
+                ++pos_;
+            }
+        };
+
+        if (pos_ != end_ && *pos_ == '-') {
+            ++pos_;
+        }
+        // Парсим целую часть числа; после 0 в JSON не могут идти другие цифры
+        if (pos_ != end_ && *pos_ == '0') {
+            ++pos_;
+            if (pos_ != end_ && IsDigit(*pos_)) {
+                throw ParsingError("Leading zeros are not allowed"s);
+            }
+        }
+        else {
+            read_digits();
+        }
 
-            return s;
+        bool is_int = true;
+        // Парсим дробную часть числа
+        if (pos_ != end_ && *pos_ == '.') {
+            ++pos_;
+            read_digits();
+            is_int = false;
         }
 
-        Node LoadNull(istream& input) {
-            std::string check = ProcessSpecialWords(input);
-            if (check == "null"sv) {
-                return Node(nullptr);
+        // Парсим экспоненциальную часть числа
+        if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+            if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) {
+                ++pos_;
             }
-            else {
-                throw ParsingError("Null parsing error");
+            read_digits();
+            is_int = false;
+        }
+
+        // Грамматика уже проверена, поэтому from_chars разбирает ровно [start, pos_)
+        if (is_int) {
+            int value = 0;
+            if (std::from_chars(start, pos_, value).ec == std::errc()) {
+                return value;
             }
+            // Целое вне диапазона int читается как double
+        }
+        double value = 0.0;
+        if (std::from_chars(start, pos_, value).ec != std::errc()) {
+            throw ParsingError("Failed to convert "s + std::string(start, pos_) + " to number"s);
+        }
+        return value;
+    }
 
+    std::string_view Parser::ParseString() {
+        const char* start = pos_;
+        pos_ = FindStringSpecial(pos_, end_);
+        if (pos_ != end_ && *pos_ == '"') {
+            ++pos_;
+            return std::string_view(start, pos_ - start - 1);
         }
 
-        Node LoadBoolean(std::istream& input) {
-            std::string check = ProcessSpecialWords(input);
-            if (check == "true"sv) {
-                return Node(true);
+        scratch_.assign(start, pos_);
+        while (true) {
+            if (pos_ == end_) {
+                // Буфер закончился до того, как встретили закрывающую кавычку
+                throw ParsingError("String parsing error"s);
             }
-            else if (check == "false"sv) {
-                return Node(false);
+            const char ch = *pos_++;
+            if (ch == '"') {
+                return scratch_;
             }
-            else {
-                throw ParsingError("Boolean parsing error");
+            if (ch == '\n' || ch == '\r') {
+                // Строковый литерал внутри JSON не может прерываться символами \r или \n
+                throw ParsingError("Unexpected end of line"s);
+            }
+            if (ch != '\\') {
+                scratch_.push_back(ch);
+                continue;
+            }
+
+            if (pos_ == end_) {
+                // Буфер завершился сразу после символа обратной косой черты
+                throw ParsingError("String parsing error"s);
+            }
+            const char escaped_char = *pos_++;
+            switch (escaped_char) {
+            case 'n':
+                scratch_.push_back('\n');
+                break;
+            case 't':
+                scratch_.push_back('\t');
+                break;
+            case 'r':
+                scratch_.push_back('\r');
+                break;
+            case 'b':
+                scratch_.push_back('\b');
+                break;
+            case 'f':
+                scratch_.push_back('\f');
+                break;
+            case '"':
+            case '\\':
+            case '/':
+                scratch_.push_back(escaped_char);
+                break;
+            case 'u':
+                AppendCodePoint(ParseUnicodeEscape());
+                break;
+            default:
+                // Встретили неизвестную escape-последовательность
+                throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
             }
         }
+    }
 
-        Node LoadNumber(istream& input) {
-            Number result = NumericParser(input);
-            if (std::holds_alternative<int>(result)) {
-                return Node(std::get<int>(result));
+    uint32_t Parser::ParseHex4() {
+        if (end_ - pos_ < 4) {
+            throw ParsingError("Invalid \\u escape sequence"s);
+        }
+        uint32_t code = 0;
+        for (int i = 0; i != 4; ++i) {
+            const char c = *pos_++;
+            code <<= 4;
+            if (IsDigit(c)) {
+                code |= static_cast<uint32_t>(c - '0');
             }
-            else if (std::holds_alternative<double>(result)) {
-                return Node(std::get<double>(result));
+            else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<uint32_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<uint32_t>(c - 'A' + 10);
             }
             else {
-                throw ParsingError("Number parsing error");
+                throw ParsingError("Invalid \\u escape sequence"s);
             }
         }
+        return code;
+    }
 
-        Node LoadString(istream& input) {
-            string line = StringParser(input);
-            return Node(move(line));
+    // \uXXXX, символы вне BMP - суррогатной парой \uD8xx\uDCxx
+    uint32_t Parser::ParseUnicodeEscape() {
+        const uint32_t code = ParseHex4();
+        if (code < 0xD800 || code > 0xDFFF) {
+            return code;
+        }
+        // Младший суррогат без старшего
+        if (code > 0xDBFF) {
+            throw ParsingError("Unpaired surrogate in \\u escape sequence"s);
         }
+        if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u') {
+            throw ParsingError("Unpaired surrogate in \\u escape sequence"s);
+        }
+        pos_ += 2;
+        const uint32_t low = ParseHex4();
+        if (low < 0xDC00 || low > 0xDFFF) {
+            throw ParsingError("Unpaired surrogate in \\u escape sequence"s);
+        }
+        return 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    }
 
-        Node LoadArray(istream& input) {
-            Array result;
+    void Parser::AppendCodePoint(uint32_t code) {
+        if (code < 0x80) {
+            scratch_.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800) {
+            scratch_.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000) {
+            scratch_.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        else {
+            scratch_.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
 
-            auto it = std::istreambuf_iterator<char>(input);
-            auto end = std::istreambuf_iterator<char>();
+    Node Parser::ParseArray() {
+        Array result;
+        if (PeekSignificant() == ']') {
+            ++pos_;
+            return Node(move(result));
+        }
 
-            if (it == end) {
-                throw ParsingError("Array parsing error");
+        while (true) {
+            result.push_back(ParseNode());
+            const char c = PeekSignificant();
+            if (c == ']') {
+                ++pos_;
+                return Node(move(result));
             }
-
-            for (char c; input >> c && c != ']';) {
-                if (c != ',') {
-                    input.putback(c);
-                }
-                result.push_back(LoadNode(input));
+            if (c != ',') {
+                throw ParsingError("Array parsing error"s);
             }
+            ++pos_;
+        }
+    }
 
+    Node Parser::ParseDict() {
+        Dict result;
+        if (PeekSignificant() == '}') {
+            ++pos_;
             return Node(move(result));
         }
 
-        Node LoadDict(istream& input) {
-            Dict result;
-
-            auto it = std::istreambuf_iterator<char>(input);
-            auto end = std::istreambuf_iterator<char>();
+        while (true) {
+            if (PeekSignificant() != '"') {
+                throw ParsingError("Dict parsing error"s);
+            }
+            ++pos_;
+            string key(ParseString());
+            if (PeekSignificant() != ':') {
+                throw ParsingError("Dict parsing error"s);
+            }
+            ++pos_;
+            result.emplace(move(key), ParseNode());
 
-            if (it == end) {
-                throw ParsingError("Dict parsing error");
+            const char c = PeekSignificant();
+            if (c == '}') {
+                ++pos_;
+                return Node(move(result));
             }
+            if (c != ',') {
+                throw ParsingError("Dict parsing error"s);
+            }
+            ++pos_;
+        }
+    }
 
-            for (char c; input >> c && c != '}';) {
+    std::string_view Parser::SkipValue() {
+        SkipSpaces();
+        const char* start = pos_;
+        if (pos_ == end_) {
+            throw ParsingError("Zero input_stream"s);
+        }
 
-                if (c == ',') {
-                    input >> c;
+        // Строки пропускаются целиком: скобки внутри них не считаются
+        auto skip_string = [this] {
+            ++pos_;
+            while (pos_ != end_ && *pos_ != '"') {
+                // Обратная косая черта в последнем символе буфера: шаг на 2 вышел бы за его конец
+                if (*pos_ == '\\' && pos_ + 1 == end_) {
+                    throw ParsingError("String parsing error"s);
                 }
+                pos_ += *pos_ == '\\' ? 2 : 1;
+            }
+            if (pos_ == end_) {
+                throw ParsingError("String parsing error"s);
+            }
+            ++pos_;
+        };
 
-                string key = LoadString(input).AsString();
-                input >> c;
-                result.insert({ move(key), LoadNode(input) });
+        if (*pos_ == '"') {
+            skip_string();
+        }
+        else if (*pos_ == '[' || *pos_ == '{') {
+            SkipContainer();
+        }
+        else {
+            // Число или литерал - до ближайшего разделителя
+            while (pos_ != end_ && !IsSpace(*pos_) && *pos_ != ',' && *pos_ != ']' && *pos_ != '}') {
+                ++pos_;
             }
+        }
+        return std::string_view(start, pos_ - start);
+    }
 
-            return Node(move(result));
+    void Parser::SkipContainer() {
+        size_t depth = 0;
+        bool in_string = false;
+        bool escaped = false;
+
+        // Целые блоки: скобки вне строк находятся по маскам, и перебираются только они
+        while (static_cast<size_t>(end_ - pos_) >= BLOCK_SIZE) {
+            const BlockMasks masks = ClassifyBlock(pos_);
+            const uint64_t quotes = masks.quote & ~EscapedMask(masks.backslash, escaped);
+            const uint64_t strings = PrefixXor(quotes) ^ (in_string ? ~uint64_t{ 0 } : uint64_t{ 0 });
+            in_string = (strings >> 63) != 0;
+
+            uint64_t brackets = (masks.open | masks.close) & ~strings;
+            while (brackets != 0) {
+                const uint64_t lowest = brackets & (~brackets + 1U);
+                if ((masks.open & lowest) != 0) {
+                    ++depth;
+                }
+                else if (--depth == 0) {
+                    pos_ += CountTrailingZeros(lowest) + 1;
+                    return;
+                }
+                brackets ^= lowest;
+            }
+            pos_ += BLOCK_SIZE;
         }
 
-        Node LoadNode(istream& input) {
-            char c;
-            if (!(input >> c)) {
-                throw ParsingError("Zero input_stream");
+        // Хвост короче блока - по байтам с тем же состоянием
+        for (; pos_ != end_; ++pos_) {
+            const char c = *pos_;
+            if (escaped) {
+                escaped = false;
+            }
+            else if (c == '\\') {
+                escaped = true;
+            }
+            else if (c == '"') {
+                in_string = !in_string;
+            }
+            else if (in_string) {
+                continue;
             }
+            else if (c == '[' || c == '{') {
+                ++depth;
+            }
+            else if ((c == ']' || c == '}') && --depth == 0) {
+                ++pos_;
+                return;
+            }
+        }
+        throw ParsingError(in_string ? "String parsing error"s : "Unexpected end of input"s);
+    }
 
-            switch (c)
-            {
-            case '[':
-                return LoadArray(input);
+    std::string_view Parser::ReadString() {
+        if (PeekSignificant() != '"') {
+            throw ParsingError("String parsing error"s);
+        }
+        ++pos_;
+        return ParseString();
+    }
 
-            case '{':
-                return LoadDict(input);
+    std::variant<int, double> Parser::ReadNumber() {
+        SkipSpaces();
+        return ParseNumber();
+    }
 
-            case '"':
-                return LoadString(input);
+    bool Parser::ReadBool() {
+        if (PeekSignificant() == 't') {
+            ExpectWord("true"sv);
+            return true;
+        }
+        ExpectWord("false"sv);
+        return false;
+    }
 
-            case 'n':
-                input.putback(c);
-                return LoadNull(input);
+    void Parser::ReadNull() {
+        SkipSpaces();
+        ExpectWord("null"sv);
+    }
 
-            case 't':
-                input.putback(c);
-                return LoadBoolean(input);
+    void Parser::StartObject() {
+        if (PeekSignificant() != '{') {
+            throw ParsingError("Dict parsing error"s);
+        }
+        ++pos_;
+        first_item_.push_back(true);
+    }
 
-            case 'f':
-                input.putback(c);
-                return LoadBoolean(input);
+    std::optional<std::string_view> Parser::NextKey() {
+        if (!NextItem('}')) {
+            return std::nullopt;
+        }
+        if (PeekSignificant() != '"') {
+            throw ParsingError("Dict parsing error"s);
+        }
+        ++pos_;
+        const std::string_view key = ParseString();
+        if (PeekSignificant() != ':') {
+            throw ParsingError("Dict parsing error"s);
+        }
+        ++pos_;
+        return key;
+    }
 
-            default:
-                input.putback(c);
-                return LoadNumber(input);
-            }
+    void Parser::StartArray() {
+        if (PeekSignificant() != '[') {
+            throw ParsingError("Array parsing error"s);
         }
+        ++pos_;
+        first_item_.push_back(true);
+    }
 
-    }  // namespace
+    bool Parser::NextElement() {
+        return NextItem(']');
+    }
+
+    bool Parser::NextItem(char close) {
+        if (first_item_.empty()) {
+            throw ParsingError("No object or array is being read"s);
+        }
+        const char c = PeekSignificant();
+        if (c == close) {
+            ++pos_;
+            first_item_.pop_back();
+            return false;
+        }
+        if (!first_item_.back()) {
+            if (c != ',') {
+                throw ParsingError(close == ']' ? "Array parsing error"s : "Dict parsing error"s);
+            }
+            ++pos_;
+        }
+        first_item_.back() = false;
+        return true;
+    }
 
     Node::Node(Value value)
         : variant(std::move(value)) {
@@ -393,8 +761,29 @@ namespace json {
         return !(root_ == rhs.root_);
     }
 
+    Document Load(std::string_view text) {
+        Parser parser(text);
+        Document document{ parser.ParseNode() };
+        parser.ExpectEnd();
+        return document;
+    }
+
     Document Load(istream& input) {
-        return Document{ LoadNode(input) };
+        const io::InputBuffer buffer = io::InputBuffer::Read(input);
+        return Load(buffer.View());
+    }
+
+    char* FormatNumber(char* first, int value) {
+        return std::to_chars(first, first + NUMBER_CHARS_MAX, value).ptr;
+    }
+
+    char* FormatNumber(char* first, double value, DoubleFormat format) {
+        char* const last = first + NUMBER_CHARS_MAX;
+        if (format == DoubleFormat::shortest) {
+            return std::to_chars(first, last, value).ptr;
+        }
+        // general с точностью 6 - то же, что printf("%g") и ostream по умолчанию
+        return std::to_chars(first, last, value, std::chars_format::general, 6).ptr;
     }
 
     void PrintContext::PrintIndent() const {
@@ -438,11 +827,13 @@ namespace json {
     }
 
     void PrintValue(int num, const PrintContext& ctx) {
-        ctx._out << num;
+        char text[NUMBER_CHARS_MAX];
+        ctx._out.write(text, FormatNumber(text, num) - text);
     }
 
     void PrintValue(double num, const PrintContext& ctx) {
-        ctx._out << num;
+        char text[NUMBER_CHARS_MAX];
+        ctx._out.write(text, FormatNumber(text, num, ctx._double_format) - text);
     }
 
     void PrintValue(bool boolean, const PrintContext& ctx) {
@@ -500,10 +891,164 @@ namespace json {
         out.put('}');
     }
 
-    void Print(const Document& doc, std::ostream& output) {
+    void Print(const Document& doc, std::ostream& output, DoubleFormat double_format) {
+        std::visit(
+            [&output, double_format](const auto& value) {
+                PrintValue(value, PrintContext(output, 4, 0, double_format)); }, doc.GetRoot().GetValue());
+    }
+
+    Writer::Writer(std::ostream& output, DoubleFormat double_format)
+        : output_(output)
+        , double_format_(double_format) {
+        buffer_.reserve(FLUSH_THRESHOLD + FLUSH_THRESHOLD / 4);
+    }
+
+    Writer::~Writer() {
+        Flush();
+    }
+
+    void Writer::Flush() {
+        output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+    void Writer::WriteIndent(size_t depth) {
+        buffer_.append(depth * 4, ' ');
+    }
+
+    void Writer::BeforeValue() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (first_item_.empty()) {
+            return;
+        }
+        if (!first_item_.back()) {
+            buffer_ += ",\n"sv;
+        }
+        first_item_.back() = false;
+        WriteIndent(first_item_.size());
+    }
+
+    void Writer::WriteString(std::string_view value) {
+        buffer_.push_back('"');
+        // Как PrintValue(string): экранируются только \r, \n, " и \\, остальное копируется отрезками
+        size_t start = 0;
+        for (size_t i = 0; i != value.size(); ++i) {
+            const char c = value[i];
+            if (c != '\r' && c != '\n' && c != '"' && c != '\\') {
+                continue;
+            }
+            buffer_.append(value.data() + start, i - start);
+            buffer_.push_back('\\');
+            buffer_.push_back(c == '\r' ? 'r' : c == '\n' ? 'n' : c);
+            start = i + 1;
+        }
+        buffer_.append(value.data() + start, value.size() - start);
+        buffer_.push_back('"');
+        if (buffer_.size() >= FLUSH_THRESHOLD) {
+            Flush();
+        }
+    }
+
+    Writer& Writer::StartDict() {
+        BeforeValue();
+        buffer_ += "{\n"sv;
+        first_item_.push_back(true);
+        return *this;
+    }
+
+    Writer& Writer::EndDict() {
+        first_item_.pop_back();
+        buffer_.push_back('\n');
+        WriteIndent(first_item_.size());
+        buffer_.push_back('}');
+        if (buffer_.size() >= FLUSH_THRESHOLD) {
+            Flush();
+        }
+        return *this;
+    }
+
+    Writer& Writer::StartArray() {
+        BeforeValue();
+        buffer_ += "[\n"sv;
+        first_item_.push_back(true);
+        return *this;
+    }
+
+    Writer& Writer::EndArray() {
+        first_item_.pop_back();
+        buffer_.push_back('\n');
+        WriteIndent(first_item_.size());
+        buffer_.push_back(']');
+        if (buffer_.size() >= FLUSH_THRESHOLD) {
+            Flush();
+        }
+        return *this;
+    }
+
+    Writer& Writer::Key(std::string_view key) {
+        if (!first_item_.back()) {
+            buffer_ += ",\n"sv;
+        }
+        first_item_.back() = false;
+        WriteIndent(first_item_.size());
+        WriteString(key);
+        buffer_ += " : "sv;
+        after_key_ = true;
+        return *this;
+    }
+
+    Writer& Writer::Value(std::string_view value) {
+        BeforeValue();
+        WriteString(value);
+        return *this;
+    }
+
+    Writer& Writer::Value(const char* value) {
+        return Value(std::string_view(value));
+    }
+
+    Writer& Writer::Value(const std::string& value) {
+        return Value(std::string_view(value));
+    }
+
+    Writer& Writer::Value(int value) {
+        BeforeValue();
+        char text[NUMBER_CHARS_MAX];
+        buffer_.append(text, FormatNumber(text, value));
+        return *this;
+    }
+
+    Writer& Writer::Value(double value) {
+        BeforeValue();
+        char text[NUMBER_CHARS_MAX];
+        buffer_.append(text, FormatNumber(text, value, double_format_));
+        return *this;
+    }
+
+    Writer& Writer::Value(bool value) {
+        BeforeValue();
+        buffer_ += value ? "true"sv : "false"sv;
+        return *this;
+    }
+
+    Writer& Writer::Value(std::nullptr_t) {
+        BeforeValue();
+        buffer_ += "null"sv;
+        return *this;
+    }
+
+    Writer& Writer::Value(const Node& node) {
+        BeforeValue();
+        // Готовый узел печатается Print с отступом текущего уровня
+        Flush();
+        const PrintContext ctx(output_, 4, static_cast<int>(first_item_.size()) * 4, double_format_);
         std::visit(
-            [&output](const auto& value) {
-                PrintValue(value, PrintContext(output, 4, 0)); }, doc.GetRoot().GetValue());
+            [&ctx](const auto& value) {
+                PrintValue(value, ctx); }, node.GetValue());
+        return *this;
     }
 
 }  // namespace json
\ No newline at end of file
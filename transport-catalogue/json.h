@@ -2,7 +2,10 @@
 
 #include <iostream>
 #include <map>
+#include <optional>
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 
@@ -71,33 +74,163 @@ namespace json {
         Node root_;
     };
 
+    // Разбор по непрерывному буферу: позиция - указатель, конец известен заранее,
+    // поэтому чтение символа не проверяет состояние потока.
+    // Кроме значения целиком умеет обходить объекты и массивы по одному элементу:
+    // Node строится только для нужных значений, остальные пропускаются без разбора
+    class Parser {
+    public:
+        explicit Parser(std::string_view text);
+
+        // Значение целиком
+        Node ParseNode();
+        // Пропускает значение, проверяя только строки и парность скобок; возвращает его текст
+        std::string_view SkipValue();
+
+        // Обход объекта: после StartObject каждый NextKey возвращает ключ очередного элемента,
+        // а его значение читается ParseNode, SkipValue или вложенным обходом.
+        // Ключ действителен до следующего вызова парсера
+        void StartObject();
+        std::optional<std::string_view> NextKey();
+        // Обход массива: после StartArray каждый true от NextElement - очередной элемент
+        void StartArray();
+        bool NextElement();
+
+        // Лексемы для построения других представлений документа.
+        // Следующий значащий символ, '\0' в конце буфера; позиция остаётся на нём
+        char PeekSignificant();
+        // После корневого значения допустимы только пробельные символы
+        void ExpectEnd();
+        // Строка с открывающей кавычкой; ссылка - в буфер или, если есть escape-последовательности,
+        // во внутренний буфер парсера до следующего вызова
+        std::string_view ReadString();
+        std::variant<int, double> ReadNumber();
+        bool ReadBool();
+        void ReadNull();
+
+    private:
+        void SkipSpaces();
+        void ExpectWord(std::string_view word);
+        std::variant<int, double> ParseNumber();
+        // Строка после открывающей кавычки. Без escape-последовательностей - ссылка в буфер,
+        // иначе строка раскодируется в scratch_ и ссылка действительна до следующего вызова
+        std::string_view ParseString();
+        uint32_t ParseHex4();
+        uint32_t ParseUnicodeEscape();
+        void AppendCodePoint(uint32_t code);
+        Node ParseArray();
+        Node ParseDict();
+        // Массив или объект целиком, начиная с открывающей скобки: по битовым маскам блоков
+        // находятся строки и скобки вне них, узлы не строятся
+        void SkipContainer();
+        // Перед очередным элементом обходимого объекта или массива: ',' или закрывающая скобка
+        bool NextItem(char close);
+
+        const char* pos_;
+        const char* end_;
+        // Строки с escape-последовательностями раскодируются сюда
+        std::string scratch_;
+        // Для каждого обходимого объекта и массива: не было ли ещё элементов
+        std::vector<bool> first_item_;
+    };
+
+    // Разбор документа целиком из непрерывного буфера
+    Document Load(std::string_view text);
+    // Поток сначала читается в память целиком
     Document Load(std::istream& input);
 
+    // Запись чисел с плавающей точкой при выводе
+    enum class DoubleFormat {
+        // 6 значащих цифр, как у ostream по умолчанию; прежний формат, действует по умолчанию
+        stream,
+        // Кратчайшая запись, которая читается обратно в то же число
+        shortest
+    };
+
+    // Наибольшая длина числа в любом из форматов вместе со знаком и экспонентой
+    constexpr size_t NUMBER_CHARS_MAX = 32U;
+
+    // Записывает число в [first, first + NUMBER_CHARS_MAX) без промежуточных строк,
+    // возвращает конец записи
+    char* FormatNumber(char* first, int value);
+    char* FormatNumber(char* first, double value, DoubleFormat format);
+
     struct PrintContext {
         PrintContext(std::ostream& out) : _out(out) {
         }
 
-        PrintContext(std::ostream& out, int indent_step, int indent = 0)
+        PrintContext(std::ostream& out, int indent_step, int indent = 0, DoubleFormat double_format = DoubleFormat::stream)
             : _out(out)
             , _indent_step(indent_step)
-            , _indent(indent) {
+            , _indent(indent)
+            , _double_format(double_format) {
         }
 
         std::ostream& _out;
         int _indent_step = 4;
         int _indent = 0;
+        DoubleFormat _double_format = DoubleFormat::stream;
 
         void PrintIndent() const;
 
         // Возвращает новый контекст вывода с увеличенным смещением
         PrintContext Indented() const {
-            return { _out, _indent_step, _indent_step + _indent };
+            return { _out, _indent_step, _indent_step + _indent, _double_format };
         }
 
         PrintContext& GetContex() {
             return *this;
         }
     };
-    void Print(const Document& doc, std::ostream& output);
+    void Print(const Document& doc, std::ostream& output, DoubleFormat double_format = DoubleFormat::stream);
+
+    // Запись JSON прямо в поток без построения Node, в том же формате, что и Print:
+    // отступ 4 пробела на уровень, ключ и значение через " : ", числа в формате double_format.
+    // Ключи выводятся в порядке вызовов - для совпадения с Print их задают по алфавиту,
+    // как их упорядочивает Dict. Текст копится в буфере и уходит в поток крупными кусками
+    class Writer {
+    public:
+        explicit Writer(std::ostream& output, DoubleFormat double_format = DoubleFormat::stream);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        Writer& StartDict();
+        Writer& EndDict();
+        Writer& StartArray();
+        Writer& EndArray();
+
+        Writer& Key(std::string_view key);
+
+        Writer& Value(std::string_view value);
+        // Без этих перегрузок строковый литерал выбрал бы Value(bool), а std::string - не выбрал бы
+        // между string_view и Node
+        Writer& Value(const char* value);
+        Writer& Value(const std::string& value);
+        Writer& Value(int value);
+        Writer& Value(double value);
+        Writer& Value(bool value);
+        Writer& Value(std::nullptr_t);
+        Writer& Value(const Node& node);
+
+        // Отдаёт накопленный текст в поток
+        void Flush();
+
+    private:
+        // Разделитель и отступ перед элементом массива; после ключа не нужны
+        void BeforeValue();
+        void WriteIndent(size_t depth);
+        void WriteString(std::string_view value);
+
+        static constexpr size_t FLUSH_THRESHOLD = 64U * 1024U;
+
+        std::ostream& output_;
+        const DoubleFormat double_format_;
+        std::string buffer_;
+        // Для каждого открытого массива и словаря: не было ли ещё элементов
+        std::vector<bool> first_item_;
+        bool after_key_ = false;
+    };
 
 }  // namespace json
\ No newline at end of file
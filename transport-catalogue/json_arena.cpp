@@ -0,0 +1,219 @@
+#include "json_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+using namespace std::literals;
+
+namespace json::arena {
+
+    const Node& Array::operator[](size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Array index out of range"s);
+        }
+        return items_[index];
+    }
+
+    const Member* Dict::find(std::string_view key) const {
+        return std::find_if(begin(), end(), [key](const Member& member) {
+            return member.first == key;
+        });
+    }
+
+    size_t Dict::count(std::string_view key) const {
+        return find(key) != end() ? 1U : 0U;
+    }
+
+    const Node& Dict::at(std::string_view key) const {
+        const Member* member = find(key);
+        if (member == end()) {
+            throw std::out_of_range("No key "s + std::string(key));
+        }
+        return member->second;
+    }
+
+    bool Node::IsInt() const {
+        return type_ == Type::integer;
+    }
+
+    bool Node::IsDouble() const {
+        return IsInt() || IsPureDouble();
+    }
+
+    bool Node::IsPureDouble() const {
+        return type_ == Type::real;
+    }
+
+    bool Node::IsBool() const {
+        return type_ == Type::boolean;
+    }
+
+    bool Node::IsString() const {
+        return type_ == Type::string;
+    }
+
+    bool Node::IsNull() const {
+        return type_ == Type::null;
+    }
+
+    bool Node::IsArray() const {
+        return type_ == Type::array;
+    }
+
+    bool Node::IsDict() const {
+        return type_ == Type::dict;
+    }
+
+    Array Node::AsArray() const {
+        if (!IsArray()) {
+            throw std::logic_error("Not an Array");
+        }
+        return { items_, size_ };
+    }
+
+    Dict Node::AsDict() const {
+        if (!IsDict()) {
+            throw std::logic_error("Not a Map");
+        }
+        return { members_, size_ };
+    }
+
+    int Node::AsInt() const {
+        if (!IsInt()) {
+            throw std::logic_error("Not an Int");
+        }
+        return integer_;
+    }
+
+    std::string_view Node::AsString() const {
+        if (!IsString()) {
+            throw std::logic_error("Not a String");
+        }
+        return { string_, size_ };
+    }
+
+    bool Node::AsBool() const {
+        if (!IsBool()) {
+            throw std::logic_error("Not a Bool");
+        }
+        return boolean_;
+    }
+
+    double Node::AsDouble() const {
+        if (IsInt()) {
+            return integer_;
+        }
+        if (!IsPureDouble()) {
+            throw std::logic_error("Not a Double");
+        }
+        return real_;
+    }
+
+    Document::Storage::Storage()
+        : resource(initial, sizeof(initial)) {
+    }
+
+    Document::Document()
+        : storage_(std::make_unique<Storage>()) {
+    }
+
+    const Node& Document::Load(std::string_view text) {
+        root_ = Node();
+        storage_->items.clear();
+        storage_->members.clear();
+        storage_->resource.release();
+
+        Parser parser(text);
+        root_ = ParseNode(parser, text);
+        parser.ExpectEnd();
+        return root_;
+    }
+
+    std::string_view Document::Keep(std::string_view value, std::string_view text) {
+        // Ссылка во входной буфер живёт вместе с ним, раскодированная строка - до следующей лексемы
+        if (value.empty() || (value.data() >= text.data() && value.data() < text.data() + text.size())) {
+            return value;
+        }
+        char* copy = static_cast<char*>(storage_->resource.allocate(value.size(), 1));
+        std::memcpy(copy, value.data(), value.size());
+        return { copy, value.size() };
+    }
+
+    Node Document::ParseNode(Parser& parser, std::string_view text) {
+        Node node;
+        switch (parser.PeekSignificant())
+        {
+        case '[': {
+            parser.StartArray();
+            const size_t first = storage_->items.size();
+            while (parser.NextElement()) {
+                Node item = ParseNode(parser, text);
+                storage_->items.push_back(item);
+            }
+            const size_t size = storage_->items.size() - first;
+            Node* items = static_cast<Node*>(storage_->resource.allocate(size * sizeof(Node), alignof(Node)));
+            std::uninitialized_copy(storage_->items.begin() + first, storage_->items.end(), items);
+            storage_->items.resize(first);
+
+            node.type_ = Node::Type::array;
+            node.size_ = static_cast<uint32_t>(size);
+            node.items_ = items;
+            break;
+        }
+
+        case '{': {
+            parser.StartObject();
+            const size_t first = storage_->members.size();
+            while (const std::optional<std::string_view> key = parser.NextKey()) {
+                const std::string_view kept = Keep(*key, text);
+                Node value = ParseNode(parser, text);
+                storage_->members.push_back({ kept, value });
+            }
+            const size_t size = storage_->members.size() - first;
+            Member* members = static_cast<Member*>(storage_->resource.allocate(size * sizeof(Member), alignof(Member)));
+            std::uninitialized_copy(storage_->members.begin() + first, storage_->members.end(), members);
+            storage_->members.resize(first);
+
+            node.type_ = Node::Type::dict;
+            node.size_ = static_cast<uint32_t>(size);
+            node.members_ = members;
+            break;
+        }
+
+        case '"': {
+            const std::string_view value = Keep(parser.ReadString(), text);
+            node.type_ = Node::Type::string;
+            node.size_ = static_cast<uint32_t>(value.size());
+            node.string_ = value.data();
+            break;
+        }
+
+        case 't':
+        case 'f':
+            node.type_ = Node::Type::boolean;
+            node.boolean_ = parser.ReadBool();
+            break;
+
+        case 'n':
+            parser.ReadNull();
+            break;
+
+        default: {
+            const std::variant<int, double> number = parser.ReadNumber();
+            if (std::holds_alternative<int>(number)) {
+                node.type_ = Node::Type::integer;
+                node.integer_ = std::get<int>(number);
+            }
+            else {
+                node.type_ = Node::Type::real;
+                node.real_ = std::get<double>(number);
+            }
+            break;
+        }
+        }
+        return node;
+    }
+
+}  // namespace json::arena
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "json.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace json::arena {
+
+    class Array;
+    class Dict;
+    struct Member;
+
+    // Узел в 16 байтах: тип, длина строки или контейнера и значение либо указатель в арену.
+    // Методы те же, что у json::Node, но строки, массивы и объекты возвращаются как
+    // ссылки в арену и во входной буфер
+    class Node {
+    public:
+        Node() = default;
+
+        bool IsInt() const;
+        bool IsDouble() const;
+        bool IsPureDouble() const;
+        bool IsBool() const;
+        bool IsString() const;
+        bool IsNull() const;
+        bool IsArray() const;
+        bool IsDict() const;
+
+        Array AsArray() const;
+        Dict AsDict() const;
+        int AsInt() const;
+        std::string_view AsString() const;
+        bool AsBool() const;
+        double AsDouble() const;
+
+    private:
+        friend class Document;
+
+        enum class Type : uint8_t {
+            null,
+            boolean,
+            integer,
+            real,
+            string,
+            array,
+            dict
+        };
+
+        Type type_ = Type::null;
+        uint32_t size_ = 0U;
+        union {
+            bool boolean_;
+            int integer_;
+            double real_;
+            const char* string_;
+            const Node* items_;
+            const Member* members_ = nullptr;
+        };
+    };
+
+    // Поля названы как у std::pair, чтобы обход объекта выглядел так же, как обход json::Dict
+    struct Member {
+        std::string_view first;
+        Node second;
+    };
+
+    // Элементы массива подряд в арене
+    class Array {
+    public:
+        Array() = default;
+        Array(const Node* items, size_t size)
+            : items_(items)
+            , size_(size) {
+        }
+
+        const Node* begin() const {
+            return items_;
+        }
+
+        const Node* end() const {
+            return items_ + size_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        const Node& operator[](size_t index) const;
+
+    private:
+        const Node* items_ = nullptr;
+        size_t size_ = 0U;
+    };
+
+    // Пары ключ-значение объекта в порядке документа. Поиск линейный: у объектов запросов
+    // десяток ключей, и просмотр подряд лежащих пар быстрее дерева или хеш-таблицы.
+    // Из повторяющихся ключей, как и у json::Dict, действует первый
+    class Dict {
+    public:
+        Dict() = default;
+        Dict(const Member* members, size_t size)
+            : members_(members)
+            , size_(size) {
+        }
+
+        const Member* begin() const {
+            return members_;
+        }
+
+        const Member* end() const {
+            return members_ + size_;
+        }
+
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        const Member* find(std::string_view key) const;
+        size_t count(std::string_view key) const;
+        // std::out_of_range, если ключа нет
+        const Node& at(std::string_view key) const;
+
+    private:
+        const Member* members_ = nullptr;
+        size_t size_ = 0U;
+    };
+
+    // Документ на арене: узлы, массивы и объекты выделяются из монотонного буфера и
+    // освобождаются разом. Строки без escape-последовательностей и ключи ссылаются во
+    // входной буфер, который должен пережить документ; раскодированные строки копируются в арену
+    class Document {
+    public:
+        Document();
+
+        Document(Document&&) noexcept = default;
+        Document& operator=(Document&&) noexcept = default;
+
+        // Разбирает text, освобождая узлы прежнего документа; первые INITIAL_BLOCK_SIZE байт
+        // арены остаются за документом, поэтому повторный разбор небольших документов не выделяет память
+        const Node& Load(std::string_view text);
+
+        const Node& GetRoot() const {
+            return root_;
+        }
+
+    private:
+        static constexpr size_t INITIAL_BLOCK_SIZE = 4096U;
+
+        struct Storage {
+            Storage();
+
+            alignas(std::max_align_t) std::byte initial[INITIAL_BLOCK_SIZE];
+            std::pmr::monotonic_buffer_resource resource;
+            // Элементы незакрытых массивов и объектов; закрытый контейнер копируется в арену
+            // одним блоком точного размера
+            std::vector<Node> items;
+            std::vector<Member> members;
+        };
+
+        Node ParseNode(Parser& parser, std::string_view text);
+        std::string_view Keep(std::string_view value, std::string_view text);
+
+        std::unique_ptr<Storage> storage_;
+        Node root_;
+    };
+
+}  // namespace json::arena
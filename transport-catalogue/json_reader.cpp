@@ -1,13 +1,22 @@
 #include "json_reader.h"
 #include "domain.h"
 #include "svg.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
 
 namespace json_reader {
 
-    JsonReader::JsonReader(std::istream& input, std::ostream& out, ProgramTask task)
-        : input_(json::Load(input))
+    JsonReader::JsonReader(std::string_view input, std::ostream& out, ProgramTask task)
+        : input_text_(input)
         , out_(out)
     {
+        if (task == json_reader::make_base) {
+            arena_ = std::make_unique<memory::IngestionArena>();
+            resource_ = arena_->GetResource();
+            request_handler_.SetMemoryResource(resource_);
+        }
+
         switch (task)
         {
         case json_reader::make_base:
@@ -16,12 +25,15 @@ namespace json_reader {
         case json_reader::process_requests:
             this->ProcessRequestsTask();
             break;
+        case json_reader::update_base:
+            this->UpdateBaseTask();
+            break;
         default:
             break;
         }
     }
 
-    void JsonReader::RouteParser(domain::Request* request, const json::Dict& node) {
+    void JsonReader::RouteParser(domain::Request* request, const Dict& node) {
         if (node.count("is_roundtrip") != 0) {
             if (node.at("is_roundtrip").AsBool()) {
                 request->is_circular_ = true;
@@ -32,14 +44,14 @@ namespace json_reader {
         }
 
         if (node.count("stops") != 0) {
-            const json::Array& stops_ = node.at("stops").AsArray();
-            for (const json::Node& stop : stops_) {
-                request->stops_.push_back(stop.AsString());
+            const Array& stops_ = node.at("stops").AsArray();
+            for (const Node& stop : stops_) {
+                request->stops_.emplace_back(stop.AsString());
             }
         }
     }
 
-    void JsonReader::StopParser(domain::Request* request, const json::Dict& node) {
+    void JsonReader::StopParser(domain::Request* request, const Dict& node) {
         if (node.count("latitude") != 0) {
             request->coordinates_.lat = node.at("latitude").AsDouble();
         }
@@ -49,14 +61,14 @@ namespace json_reader {
         }
 
         if (node.count("road_distances") != 0) {
-            const json::Dict& distances_ = node.at("road_distances").AsDict();
+            const Dict& distances_ = node.at("road_distances").AsDict();
             for (const auto& item : distances_) {
-                request->distances_[item.first] = static_cast<int64_t>(item.second.AsInt());
+                request->distances_.emplace(item.first, static_cast<int64_t>(item.second.AsInt()));
             }
         }
 
     }
-    void JsonReader::ParseBaseRequest(domain::Request* request, const json::Dict& node)
+    void JsonReader::ParseBaseRequest(domain::Request* request, const Dict& node)
     {
         if (node.count("name") != 0) {
             request->name_ = node.at("name").AsString();
@@ -76,7 +88,7 @@ namespace json_reader {
         }
     }
 
-    void JsonReader::ParseStatRequest(domain::Request* request, const json::Dict& node)
+    void JsonReader::ParseStatRequest(domain::Request* request, const Dict& node)
     {
 
         if (node.count("id") != 0) {
@@ -95,6 +107,60 @@ namespace json_reader {
             request->to_ = node.at("to").AsString();
         }
 
+        if (node.count("to_any") != 0) {
+            for (const Node& stop : node.at("to_any").AsArray()) {
+                request->to_any_.emplace_back(stop.AsString());
+            }
+        }
+
+        if (node.count("to_bus") != 0) {
+            request->to_bus_ = node.at("to_bus").AsString();
+        }
+
+        if (node.count("latitude") != 0) {
+            request->coordinates_.lat = node.at("latitude").AsDouble();
+        }
+
+        if (node.count("longitude") != 0) {
+            request->coordinates_.lng = node.at("longitude").AsDouble();
+        }
+
+        if (node.count("min_latitude") != 0) {
+            request->coordinates_.lat = node.at("min_latitude").AsDouble();
+        }
+
+        if (node.count("min_longitude") != 0) {
+            request->coordinates_.lng = node.at("min_longitude").AsDouble();
+        }
+
+        if (node.count("max_latitude") != 0) {
+            request->max_coordinates_.lat = node.at("max_latitude").AsDouble();
+        }
+
+        if (node.count("max_longitude") != 0) {
+            request->max_coordinates_.lng = node.at("max_longitude").AsDouble();
+        }
+
+        if (node.count("count") != 0) {
+            request->count_ = static_cast<size_t>(std::max(0, node.at("count").AsInt()));
+        }
+
+        if (node.count("radius") != 0) {
+            request->radius_ = node.at("radius").AsDouble();
+        }
+
+        if (node.count("prefix") != 0) {
+            request->prefix_ = node.at("prefix").AsString();
+        }
+
+        if (node.count("limit") != 0) {
+            request->count_ = static_cast<size_t>(std::max(0, node.at("limit").AsInt()));
+        }
+
+        if (node.count("max_edits") != 0) {
+            request->max_edits_ = static_cast<size_t>(std::max(0, node.at("max_edits").AsInt()));
+        }
+
         if (node.count("type") != 0) {
             if (node.at("type").AsString() == "Bus") {
                 request->key_ = "Bus";
@@ -108,10 +174,60 @@ namespace json_reader {
             else if (node.at("type").AsString() == "Route") {
                 request->key_ = "Route";
             }
+            else if (node.at("type").AsString() == "Connect") {
+                request->key_ = "Connect";
+            }
+            else if (node.at("type").AsString() == "NearestStops") {
+                request->key_ = "NearestStops";
+            }
+            else if (node.at("type").AsString() == "StopsInRadius") {
+                request->key_ = "StopsInRadius";
+            }
+            else if (node.at("type").AsString() == "StopsInBox") {
+                request->key_ = "StopsInBox";
+            }
+            else if (node.at("type").AsString() == "StopSearch") {
+                request->key_ = "StopSearch";
+                if (node.count("limit") == 0) {
+                    request->count_ = STOP_SEARCH_DEFAULT_LIMIT;
+                }
+            }
         }
     }
 
-    void JsonReader::ParseRenderRequest(map_renderer::RendererSettings& settings, const json::Dict& node) {
+    void JsonReader::ParseUpdateRequest(domain::Request* request, const Dict& node)
+    {
+        const std::string_view type = node.at("type").AsString();
+        if (type == "StopCoordinates") {
+            request->type_ = transport_catalogue::RequestType::update_stop_coordinates;
+            request->name_ = node.at("name").AsString();
+            request->coordinates_.lat = node.at("latitude").AsDouble();
+            request->coordinates_.lng = node.at("longitude").AsDouble();
+        }
+        else if (type == "RoadDistance") {
+            request->type_ = transport_catalogue::RequestType::set_road_distance;
+            request->name_ = node.at("from").AsString();
+            const int distance = node.at("distance").AsInt();
+            if (distance < 0) {
+                throw std::out_of_range("RoadDistance distance must not be negative"s);
+            }
+            request->distances_.emplace(node.at("to").AsString(), static_cast<int64_t>(distance));
+        }
+        else if (type == "AddStopToBus") {
+            request->type_ = transport_catalogue::RequestType::add_stop_to_bus;
+            request->name_ = node.at("bus").AsString();
+            request->stops_.emplace_back(node.at("stop").AsString());
+            if (node.count("position") != 0) {
+                const int position = node.at("position").AsInt();
+                if (position < 0) {
+                    throw std::out_of_range("AddStopToBus position must not be negative"s);
+                }
+                request->position_ = static_cast<size_t>(position);
+            }
+        }
+    }
+
+    void JsonReader::ParseRenderRequest(map_renderer::RendererSettings& settings, const Dict& node) {
 
         settings.width_ = node.at("width").AsDouble();
         settings.height_ = node.at("height").AsDouble();
@@ -125,7 +241,7 @@ namespace json_reader {
         settings.underlayer_color_ = ParseColor(node.at("underlayer_color"s));
         settings.underlayer_width_ = node.at("underlayer_width"s).AsDouble();
 
-        const json::Node& color_palette_node = node.at("color_palette"s);
+        const Node& color_palette_node = node.at("color_palette"s);
         size_t arr_size = color_palette_node.AsArray().size();
         if (arr_size != 0) {
             settings.color_palette_.clear();
@@ -136,7 +252,7 @@ namespace json_reader {
         }
     }
 
-    void JsonReader::ParseRouteSettingsRequest(transport_catalogue::router::RouterSettings& settings, const json::Dict& node)
+    void JsonReader::ParseRouteSettingsRequest(transport_catalogue::router::RouterSettings& settings, const Dict& node)
     {
         for (auto& item : node) {
             if (item.first == "bus_wait_time"s)
@@ -147,6 +263,18 @@ namespace json_reader {
             {
                 settings._bus_velocity = (item.second.AsDouble());
             }
+            else if (item.first == "huge_pages"s)
+            {
+                settings._huge_page_policy = memory::ParseHugePagePolicy(item.second.AsString());
+            }
+            else if (item.first == "walking_radius"s)
+            {
+                settings._walking_radius = item.second.AsDouble();
+            }
+            else if (item.first == "walking_velocity"s)
+            {
+                settings._walking_velocity = item.second.AsDouble();
+            }
             else
             {
                 continue;
@@ -154,48 +282,91 @@ namespace json_reader {
         }
     }
 
-    void JsonReader::ProcessBaseRequests(const json::Array& arr)
+    void JsonReader::ProcessBaseRequests(const Array& arr)
     {
 
         domain::RequestsMap request_map;
         for (const auto& request : arr) {
-            domain::Request base_request;
+            domain::Request base_request(resource_);
             ParseBaseRequest(&base_request, request.AsDict());
-            request_map[base_request.type_].emplace_back(base_request);
+            request_map.try_emplace(base_request.type_, resource_).first->second.push_back(std::move(base_request));
         }
         if (!request_map.empty()) {
             request_handler_.HandleBaseRequests(std::move(request_map));
         }
     }
 
-    void JsonReader::ProcessStatRequests(const json::Array& arr)
+    void JsonReader::ProcessUpdateRequests(const Array& arr)
     {
-        json::Array result;
-
-        result.reserve(arr.size());
+        domain::RequestsList requests(resource_);
+        requests.reserve(arr.size());
         for (const auto& request : arr) {
-            domain::Request stat_request;
-            ParseStatRequest(&stat_request, request.AsDict());
-            if (stat_request.key_ == "Stop") {
-                result.push_back(StopToNode(stat_request.id_, request_handler_.GetStop(stat_request.name_)).GetRoot());
-            }
-            else if (stat_request.key_ == "Bus") {
-                result.push_back(BusToNode(stat_request.id_, request_handler_.GetBus(stat_request.name_)).GetRoot());
+            domain::Request update_request(resource_);
+            ParseUpdateRequest(&update_request, request.AsDict());
+            requests.push_back(std::move(update_request));
+        }
+        request_handler_.HandleUpdateRequests(requests);
+    }
+
+    void JsonReader::ProcessStatRequests(json::Parser& requests)
+    {
+        // В памяти только текущий запрос: ответ пишется в поток, как только готов
+        json::Writer writer(out_);
+        writer.StartArray();
+        // Документ запроса разбирается заново в ту же арену
+        Document request;
+        requests.StartArray();
+        while (requests.NextElement()) {
+            AnswerStatRequest(writer, request.Load(requests.SkipValue()).AsDict());
+        }
+        writer.EndArray();
+    }
+
+    void JsonReader::AnswerStatRequest(json::Writer& writer, const Dict& request)
+    {
+        domain::Request stat_request;
+        ParseStatRequest(&stat_request, request);
+
+        // Снимок держится до конца запроса: ответы ссылаются в его данные
+        const auto snapshot = request_handler_.GetSnapshot();
+        if (stat_request.key_ == "Stop") {
+            WriteStop(writer, stat_request.id_, snapshot->GetStop(stat_request.name_));
+        }
+        else if (stat_request.key_ == "Bus") {
+            WriteBus(writer, stat_request.id_, snapshot->GetBus(stat_request.name_));
+        }
+        else if (stat_request.key_ == "Map") {
+            WriteMap(writer, stat_request.id_, snapshot->GetMap());
+        }
+        else if (stat_request.key_ == "Route") {
+            if (!stat_request.to_any_.empty()) {
+                WriteRoute(writer, stat_request.id_, snapshot->GetRouteToAny(stat_request.from_, stat_request.to_any_));
             }
-            else if (stat_request.key_ == "Map") {
-                auto doc = MapToNode(stat_request.id_, request_handler_.GetMap());
-                result.push_back(MapToNode(stat_request.id_, request_handler_.GetMap()).GetRoot());
+            else if (!stat_request.to_bus_.empty()) {
+                WriteRoute(writer, stat_request.id_, snapshot->GetRouteToBus(stat_request.from_, stat_request.to_bus_));
             }
-            else if (stat_request.key_ == "Route") {
-                result.push_back(RouteToNode(stat_request.id_, request_handler_.GetRoute(stat_request.from_, stat_request.to_)).GetRoot());
+            else {
+                WriteRoute(writer, stat_request.id_, snapshot->GetRoute(stat_request.from_, stat_request.to_));
             }
         }
-
-        Printer(std::move(result));
-
+        else if (stat_request.key_ == "Connect") {
+            WriteConnection(writer, stat_request.id_, snapshot->GetConnection(stat_request.from_, stat_request.to_));
+        }
+        else if (stat_request.key_ == "NearestStops") {
+            WriteNearbyStops(writer, stat_request.id_, snapshot->GetNearestStops(stat_request.coordinates_, stat_request.count_));
+        }
+        else if (stat_request.key_ == "StopsInRadius") {
+            WriteNearbyStops(writer, stat_request.id_, snapshot->GetStopsInRadius(stat_request.coordinates_, stat_request.radius_));
+        }
+        else if (stat_request.key_ == "StopsInBox") {
+            WriteNearbyStops(writer, stat_request.id_, snapshot->GetStopsInBox(stat_request.coordinates_, stat_request.max_coordinates_));
+        }
+        else if (stat_request.key_ == "StopSearch") {
+            WriteStopSearch(writer, stat_request.id_, snapshot->SearchStops(stat_request.prefix_, stat_request.count_, stat_request.max_edits_));
+        }
     }
 
-    void JsonReader::ProcessRenderRequest(const json::Dict& render_settings)
+    void JsonReader::ProcessRenderRequest(const Dict& render_settings)
     {
         map_renderer::RendererSettings settings;
 
@@ -205,7 +376,7 @@ namespace json_reader {
 
     }
 
-    void JsonReader::ProcessRouteSettingsRequest(const json::Dict& route_settings)
+    void JsonReader::ProcessRouteSettingsRequest(const Dict& route_settings)
     {
         transport_catalogue::router::RouterSettings settings;
 
@@ -217,203 +388,323 @@ namespace json_reader {
         }
     }
 
+    JsonReader::TopLevelValues JsonReader::ScanTopLevel() const {
+        TopLevelValues values;
+        json::Parser parser(input_text_);
+        parser.StartObject();
+        while (const std::optional<std::string_view> key = parser.NextKey()) {
+            std::optional<std::string_view>* value = *key == "base_requests"sv ? &values.base_requests
+                : *key == "render_settings"sv ? &values.render_settings
+                : *key == "routing_settings"sv ? &values.routing_settings
+                : *key == "serialization_settings"sv ? &values.serialization_settings
+                : *key == "update_requests"sv ? &values.update_requests
+                : *key == "stat_requests"sv ? &values.stat_requests
+                : nullptr;
+            const std::string_view text = parser.SkipValue();
+            if (value != nullptr && !*value) {
+                *value = text;
+            }
+        }
+        parser.ExpectEnd();
+        return values;
+    }
+
     void JsonReader::MakeBaseTask()
     {
-        const json::Dict& json_requests = input_.GetRoot().AsDict();
+        const TopLevelValues values = ScanTopLevel();
+
+        // Настройки нужны в начале и в конце; остальные разделы по очереди разбираются в section,
+        // и память прежнего раздела переиспользуется
+        Document settings;
+        Document section;
+
+        // Режим координат нужен до добавления остановок
+        if (values.serialization_settings)
+        {
+            const Dict serialization_settings = settings.Load(*values.serialization_settings).AsDict();
+            if (serialization_settings.count("quantize_coordinates"))
+            {
+                request_handler_.SetCoordinatesQuantization(serialization_settings.at("quantize_coordinates").AsBool());
+            }
+            if (serialization_settings.count("memory_report"))
+            {
+                memory_report_ = serialization_settings.at("memory_report").AsBool();
+            }
+        }
+
+        if (values.base_requests)
+        {
+            ProcessBaseRequests(section.Load(*values.base_requests).AsArray());
+        }
 
-        if (json_requests.count("base_requests"))
+        if (values.render_settings)
         {
-            ProcessBaseRequests(json_requests.at("base_requests").AsArray());
+            ProcessRenderRequest(section.Load(*values.render_settings).AsDict());
         }
 
-        if (json_requests.count("render_settings"))
+        if (values.routing_settings)
         {
-            ProcessRenderRequest(json_requests.at("render_settings").AsDict());
+            ProcessRouteSettingsRequest(section.Load(*values.routing_settings).AsDict());
         }
 
-        if (json_requests.count("routing_settings"))
+        if (values.serialization_settings)
         {
-            ProcessRouteSettingsRequest(json_requests.at("routing_settings").AsDict());
+            WriteBase(std::string(settings.GetRoot().AsDict().at("file").AsString()));
         }
 
-        if (json_requests.count("serialization_settings"))
+        if (memory_report_)
         {
-            std::ofstream output(json_requests.at("serialization_settings").AsDict().at("file").AsString(), std::ios::binary);
+            memory::PrintResourceCounters(std::cerr, arena_->GetCounters());
+            // Таблица роутера ещё жива, поэтому видно, сколько её страниц стали huge-страницами
+            memory::PrintHugePageCounters(std::cerr, memory::GetHugePageCounters());
+            request_handler_.PrintCatalogueMemory(std::cerr);
+        }
+    }
+
+    void JsonReader::ReadBase(const std::string& file)
+    {
+        std::ifstream input(file, std::ios::binary);
+        if (!input || !request_handler_.DeserializeData(input)) {
+            throw std::runtime_error("Failed to read base "s + file);
+        }
+    }
+
+    void JsonReader::WriteBase(const std::string& file)
+    {
+        // База пишется во временный файл и подменяет прежнюю, только если записана целиком:
+        // при ошибке или прерывании прежняя база остаётся нетронутой
+        const std::string temporary = file + ".tmp"s;
+        {
+            std::ofstream output(temporary, std::ios::binary);
+            const bool written = output && request_handler_.SerializeData(output);
+            output.close();
+            if (!written || !output) {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Failed to write base "s + file);
+            }
+        }
+
+        if (std::rename(temporary.c_str(), file.c_str()) != 0) {
+            // rename не заменяет существующий файл на Windows
+            std::remove(file.c_str());
+            if (std::rename(temporary.c_str(), file.c_str()) != 0) {
+                throw std::runtime_error("Failed to replace base "s + file);
+            }
+        }
+    }
+
+    void JsonReader::UpdateBaseTask()
+    {
+        const TopLevelValues values = ScanTopLevel();
+        Document settings;
+        const std::string file(settings.Load(values.serialization_settings.value()).AsDict().at("file").AsString());
+
+        ReadBase(file);
+        request_handler_.PublishSnapshot();
 
-            assert(request_handler_.SerializeData(output));
+        if (values.update_requests)
+        {
+            Document updates;
+            ProcessUpdateRequests(updates.Load(*values.update_requests).AsArray());
         }
+
+        WriteBase(file);
     }
 
     void JsonReader::ProcessRequestsTask()
     {
-        const json::Dict& json_requests = input_.GetRoot().AsDict();
+        // База и изменения нужны до первого запроса, в каком бы порядке ключи ни шли в файле
+        const TopLevelValues values = ScanTopLevel();
 
-        if (json_requests.count("serialization_settings"))
+        if (values.serialization_settings)
         {
-            std::ifstream input(json_requests.at("serialization_settings").AsDict().at("file").AsString(), std::ios::binary);
+            Document settings;
+            ReadBase(std::string(settings.Load(*values.serialization_settings).AsDict().at("file").AsString()));
+        }
 
-            assert(request_handler_.DeserializeData(input));
+        request_handler_.PublishSnapshot();
+
+        // Изменения видны запросам, идущим после них; база на диске не меняется
+        if (values.update_requests)
+        {
+            Document updates;
+            ProcessUpdateRequests(updates.Load(*values.update_requests).AsArray());
+            request_handler_.PublishSnapshot();
         }
 
-        if (json_requests.count("stat_requests"))
+        if (values.stat_requests)
         {
-            ProcessStatRequests(json_requests.at("stat_requests").AsArray());
+            json::Parser requests(*values.stat_requests);
+            ProcessStatRequests(requests);
         }
     }
 
-    const json::Document JsonReader::StopToNode(size_t id, domain::StopStat* stop_stat) const {
+    void JsonReader::WriteNotFound(json::Writer& writer, size_t id) const {
+
+        writer.StartDict()
+            .Key("error_message"sv).Value("not found"sv)
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .EndDict();
+    }
+
+    void JsonReader::WriteStop(json::Writer& writer, size_t id, const domain::StopStat* stop_stat) const {
 
         if (stop_stat == nullptr) {
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .Key("error_message"s).Value("not found"s)
-                .EndDict()
-                .Build());
-        }
-        else {
-            json::Array buses;
-            for (auto& bus : stop_stat->buses_) {
-                buses.push_back(json::Node{ std::string(bus) });
-            }
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("buses"s).Value(buses)
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .EndDict()
-                .Build());
+            WriteNotFound(writer, id);
+            return;
         }
 
+        writer.StartDict().Key("buses"sv).StartArray();
+        for (const std::string_view bus : stop_stat->buses_) {
+            writer.Value(bus);
+        }
+        writer.EndArray()
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .EndDict();
     }
-    const json::Document JsonReader::BusToNode(size_t id, domain::BusStat* bus_stat) const {
+
+    void JsonReader::WriteBus(json::Writer& writer, size_t id, const domain::BusStat* bus_stat) const {
 
         if (bus_stat == nullptr) {
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .Key("error_message"s).Value("not found"s)
-                .EndDict()
-                .Build());
-        }
-        else {
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .Key("curvature"s).Value(bus_stat->route_curvature_)
-                .Key("route_length"s).Value(static_cast<int>(bus_stat->route_length_))
-                .Key("stop_count"s).Value(static_cast<int>(bus_stat->bus_stops_num_))
-                .Key("unique_stop_count"s).Value(static_cast<int>(bus_stat->unique_stops_num_))
-                .EndDict()
-                .Build());
+            WriteNotFound(writer, id);
+            return;
         }
+
+        writer.StartDict()
+            .Key("curvature"sv).Value(bus_stat->route_curvature_)
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .Key("route_length"sv).Value(static_cast<int>(bus_stat->route_length_))
+            .Key("stop_count"sv).Value(static_cast<int>(bus_stat->bus_stops_num_))
+            .Key("unique_stop_count"sv).Value(static_cast<int>(bus_stat->unique_stops_num_))
+            .EndDict();
     }
 
-    const json::Document JsonReader::MapToNode(size_t id, const std::string& map) const {
+    void JsonReader::WriteMap(json::Writer& writer, size_t id, const std::string& map) const {
 
-        return json::Document(
-            json::Builder()
-            .StartDict()
-            .Key("map"s).Value(map)
-            .Key("request_id"s).Value(static_cast<int>(id))
-            .EndDict()
-            .Build());
+        writer.StartDict()
+            .Key("map"sv).Value(map)
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .EndDict();
     }
 
-    const json::Document JsonReader::RouteToNode(size_t id, domain::RouteStat route_stat) const
+    void JsonReader::WriteRoute(json::Writer& writer, size_t id, const domain::RouteStat& route_stat) const
     {
         if (!route_stat.is_found_) {
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .Key("error_message"s).Value("not found"s)
-                .EndDict()
-                .Build());
+            WriteNotFound(writer, id);
+            return;
         }
-        else {
-            json::Array route_items;
-            for (auto& item : route_stat.route_items_) {
-
-                if (item.GetType() == graph::wait)
-                {
-                    route_items.push_back(
-                        json::Builder()
-                        .StartDict()
-                        .Key("type"s).Value(std::string("Wait"s))
-                        .Key("stop_name"s).Value(std::string(item.GetName()))
-                        .Key("time"s).Value(item.GetTime())
-                        .EndDict()
-                        .Build());
-                }
-                else
-                {
-                    route_items.push_back(
-                        json::Builder()
-                        .StartDict()
-                        .Key("type"s).Value(std::string("Bus"s))
-                        .Key("bus"s).Value(std::string(item.GetName()))
-                        .Key("span_count"s).Value(item.GetSpanCount())
-                        .Key("time"s).Value(item.GetTime())
-                        .EndDict()
-                        .Build());
-                }
 
+        writer.StartDict().Key("items"sv).StartArray();
+        for (const auto& item : route_stat.route_items_) {
+
+            if (item.GetType() == graph::wait || item.GetType() == graph::walk)
+            {
+                writer.StartDict()
+                    .Key("stop_name"sv).Value(item.GetName())
+                    .Key("time"sv).Value(item.GetTime())
+                    .Key("type"sv).Value(item.GetType() == graph::wait ? "Wait"sv : "Walk"sv)
+                    .EndDict();
+            }
+            else
+            {
+                writer.StartDict()
+                    .Key("bus"sv).Value(item.GetName())
+                    .Key("span_count"sv).Value(item.GetSpanCount())
+                    .Key("time"sv).Value(item.GetTime())
+                    .Key("type"sv).Value("Bus"sv)
+                    .EndDict();
             }
-            return json::Document(
-                json::Builder()
-                .StartDict()
-                .Key("request_id"s).Value(static_cast<int>(id))
-                .Key("total_time"s).Value(route_stat.total_time_)
-                .Key("items"s).Value(route_items)
-                .EndDict()
-                .Build());
+
         }
+        writer.EndArray()
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .Key("total_time"sv).Value(route_stat.total_time_)
+            .EndDict();
+    }
+
+    void JsonReader::WriteConnection(json::Writer& writer, size_t id, const domain::ConnectionStat& connection_stat) const
+    {
+        if (!connection_stat.is_found_) {
+            WriteNotFound(writer, id);
+            return;
+        }
+
+        writer.StartDict().Key("buses"sv).StartArray();
+        for (const auto& item : connection_stat.connections_) {
+            writer.StartDict()
+                .Key("bus"sv).Value(item.bus_name_)
+                .Key("route_length"sv).Value(static_cast<int>(item.route_length_))
+                .Key("span_count"sv).Value(item.span_count_)
+                .EndDict();
+        }
+        writer.EndArray()
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .EndDict();
     }
 
-    svg::Point JsonReader::ParsePoint(const json::Node& node) const {
+    void JsonReader::WriteNearbyStops(json::Writer& writer, size_t id, const domain::NearbyStopsStat& stops_stat) const
+    {
+        writer.StartDict()
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .Key("stops"sv).StartArray();
+        for (const auto& item : stops_stat) {
+            writer.StartDict()
+                .Key("distance"sv).Value(item.distance_)
+                .Key("name"sv).Value(item.stop_name_)
+                .EndDict();
+        }
+        writer.EndArray().EndDict();
+    }
+
+    void JsonReader::WriteStopSearch(json::Writer& writer, size_t id, const domain::StopSearchStat& stops_stat) const
+    {
+        writer.StartDict()
+            .Key("request_id"sv).Value(static_cast<int>(id))
+            .Key("stops"sv).StartArray();
+        for (const auto& item : stops_stat) {
+            writer.StartDict()
+                .Key("bus_count"sv).Value(static_cast<int>(item.bus_count_))
+                .Key("name"sv).Value(item.stop_name_)
+                .EndDict();
+        }
+        writer.EndArray().EndDict();
+    }
 
-        const json::Array& array = node.AsArray();
-        const json::Node& x = array[0];
-        const json::Node& y = array[1];
+    svg::Point JsonReader::ParsePoint(const Node& node) const {
+
+        const Array& array = node.AsArray();
+        const Node& x = array[0];
+        const Node& y = array[1];
 
         return { x.AsDouble(), y.AsDouble() };
     }
 
-    svg::Color JsonReader::ParseColor(const json::Node& node) const {
+    svg::Color JsonReader::ParseColor(const Node& node) const {
         if (node.IsArray()) {
-            const json::Array& array = node.AsArray();
+            const Array& array = node.AsArray();
 
-            const json::Node& red_color = array[0];
+            const Node& red_color = array[0];
             const uint8_t red = static_cast<uint8_t>(red_color.AsInt());
 
-            const json::Node& green_color = array[1];
+            const Node& green_color = array[1];
             const uint8_t green = static_cast<uint8_t>(green_color.AsInt());
 
-            const json::Node& blue_color = array[2];
+            const Node& blue_color = array[2];
             const uint8_t blue = static_cast<uint8_t>(blue_color.AsInt());
 
             if (array.size() == 3U) {
                 return svg::Rgb{ red, green, blue };
             }
             else if (array.size() == 4U) {
-                const json::Node& alpha = array[3];
+                const Node& alpha = array[3];
                 return svg::Rgba{ red, green, blue, alpha.AsDouble() };
             }
         }
         else {
-            return node.AsString();
+            return std::string(node.AsString());
         }
 
         return {};
     }
 
-    void JsonReader::Printer(json::Array&& result)
-    {
-        json::Print(json::Document{ result }, out_);
-    }
-
 }
\ No newline at end of file
@@ -1,56 +1,126 @@
 #pragma once
 
 #include "request_handler.h"
-#include "json_builder.h"
+#include "json.h"
+#include "json_arena.h"
+#include "huge_page_allocator.h"
+#include "memory_resource.h"
 
 #include <sstream>
-#include <cassert>
 #include <optional>
 #include <fstream>
+#include <memory>
+#include <string_view>
 
 using namespace std::literals;
 
 namespace json_reader {
 
+    // Представление документа, по которому разбираются запросы. Разбор пользуется только
+    // общими методами json::Node и json::arena::Node; выбирается опцией сборки
+    // TRANSPORT_CATALOGUE_ARENA_JSON: по умолчанию DOM на арене, без неё - json::Document на std::map
+#ifdef TRANSPORT_CATALOGUE_ARENA_JSON
+    using Document = json::arena::Document;
+    using Node = json::arena::Node;
+    using Dict = json::arena::Dict;
+    using Array = json::arena::Array;
+#else
+    // json::Document с тем же Load, что у json::arena::Document
+    class Document {
+    public:
+        const json::Node& Load(std::string_view text) {
+            document_ = json::Load(text);
+            return document_.GetRoot();
+        }
+
+        const json::Node& GetRoot() const {
+            return document_.GetRoot();
+        }
+
+    private:
+        json::Document document_;
+    };
+    using Node = json::Node;
+    using Dict = json::Dict;
+    using Array = json::Array;
+#endif
+
+    // Сколько остановок возвращает StopSearch без limit
+    constexpr size_t STOP_SEARCH_DEFAULT_LIMIT = 10U;
+
     enum ProgramTask {
         make_base,
-        process_requests
+        process_requests,
+        update_base
     };
 
     class JsonReader {
     public:
-        JsonReader(std::istream& input, std::ostream& out, json_reader::ProgramTask task);
+        // input - JSON запроса целиком; должен жить, пока выполняется конструктор
+        JsonReader(std::string_view input, std::ostream& out, json_reader::ProgramTask task);
+
+        svg::Point ParsePoint(const Node& node) const;
+        void RouteParser(domain::Request* request, const Dict& node);
+        void StopParser(domain::Request* request, const Dict& node);
+
+        void ParseBaseRequest(domain::Request*, const Dict&);
+        void ParseStatRequest(domain::Request*, const Dict&);
+        void ParseUpdateRequest(domain::Request*, const Dict&);
+        void ParseRenderRequest(map_renderer::RendererSettings& settings, const Dict& node);
+        void ParseRouteSettingsRequest(transport_catalogue::router::RouterSettings& settings, const Dict&);
 
-        svg::Point ParsePoint(const json::Node& node) const;
-        void RouteParser(domain::Request* request, const json::Dict& node);
-        void StopParser(domain::Request* request, const json::Dict& node);
+        void ProcessBaseRequests(const Array& arr);
+        // Элементы массива stat_requests разбираются и получают ответ по одному
+        void ProcessStatRequests(json::Parser& requests);
+        // Ответ на один запрос; на запрос неизвестного типа ничего не пишется
+        void AnswerStatRequest(json::Writer& writer, const Dict& request);
+        void ProcessUpdateRequests(const Array& arr);
+        void ProcessRenderRequest(const Dict& render_settings);
+        void ProcessRouteSettingsRequest(const Dict& route_settings);
 
-        void ParseBaseRequest(domain::Request*, const json::Dict&);
-        void ParseStatRequest(domain::Request*, const json::Dict&);
-        void ParseRenderRequest(map_renderer::RendererSettings& settings, const json::Dict& node);
-        void ParseRouteSettingsRequest(transport_catalogue::router::RouterSettings& settings, const json::Dict&);
+        // Тексты значений ключей верхнего уровня. Находятся без построения узлов, а разбирается
+        // потом только то, что нужно режиму; из повторяющихся ключей действует первый
+        struct TopLevelValues {
+            std::optional<std::string_view> base_requests;
+            std::optional<std::string_view> render_settings;
+            std::optional<std::string_view> routing_settings;
+            std::optional<std::string_view> serialization_settings;
+            std::optional<std::string_view> update_requests;
+            std::optional<std::string_view> stat_requests;
+        };
+        TopLevelValues ScanTopLevel() const;
 
-        void ProcessBaseRequests(const json::Array& arr);
-        void ProcessStatRequests(const json::Array& arr);
-        void ProcessRenderRequest(const json::Dict& render_settings);
-        void ProcessRouteSettingsRequest(const json::Dict& route_settings);
+        // std::runtime_error, если база не прочитана или не записана целиком.
+        // Запись атомарна: прежний файл заменяется только готовым новым
+        void ReadBase(const std::string& file);
+        void WriteBase(const std::string& file);
 
         void MakeBaseTask();
         void ProcessRequestsTask();
+        void UpdateBaseTask();
 
-        const json::Document StopToNode(size_t id, domain::StopStat* stop_stat) const;
-        const json::Document BusToNode(size_t id, domain::BusStat* bus_stat) const;
-        const json::Document MapToNode(size_t id, const std::string& map) const;
-        const json::Document RouteToNode(size_t id, domain::RouteStat route) const;
+        // Ответы пишутся прямо в поток; ключи идут по алфавиту, как их печатал json::Print
+        void WriteNotFound(json::Writer& writer, size_t id) const;
+        void WriteStop(json::Writer& writer, size_t id, const domain::StopStat* stop_stat) const;
+        void WriteBus(json::Writer& writer, size_t id, const domain::BusStat* bus_stat) const;
+        void WriteMap(json::Writer& writer, size_t id, const std::string& map) const;
+        void WriteRoute(json::Writer& writer, size_t id, const domain::RouteStat& route) const;
+        void WriteConnection(json::Writer& writer, size_t id, const domain::ConnectionStat& connection) const;
+        void WriteNearbyStops(json::Writer& writer, size_t id, const domain::NearbyStopsStat& stops) const;
+        void WriteStopSearch(json::Writer& writer, size_t id, const domain::StopSearchStat& stops) const;
 
-        svg::Color ParseColor(const json::Node& node) const;
-
-        void Printer(json::Array&& result);
+        svg::Color ParseColor(const Node& node) const;
 
     private:
-        json::Document input_;
+        // Буфер входного файла; документы разделов ссылаются в него
+        std::string_view input_text_;
         std::ostream& out_;
 
+        // Арена make_base объявлена раньше обработчика, чтобы пережить всё, что в ней размещено
+        std::unique_ptr<memory::IngestionArena> arena_ = nullptr;
+        std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+        bool memory_report_ = false;
+
         request_handler::RequestHandler request_handler_;
         domain::RequestsMap json_requests_ = {};
         std::deque<domain::Request> base_requests_data_;
@@ -1,12 +1,14 @@
 #include <fstream>
+#include <exception>
 #include <iostream>
 #include <string_view>
+#include "input_buffer.h"
 #include "json_reader.h"
 
 using namespace std::literals;
 
 void PrintUsage(std::ostream& stream = std::cerr) {
-    stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+    stream << "Usage: transport_catalogue [make_base|process_requests|update_base]\n"sv;
 }
 
 int main(int argc, char* argv[]) {
@@ -15,24 +17,37 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    const std::string_view mode(argv[1]);
+    try {
+        const std::string_view mode(argv[1]);
 
-    if (mode == "make_base"sv) {
+        if (mode == "make_base"sv) {
 
-        std::ifstream in("make_base.json"s);
-        json_reader::JsonReader json_reader(in, std::cout, json_reader::make_base);
+            const io::InputBuffer in = io::InputBuffer::Open("make_base.json"s);
+            json_reader::JsonReader json_reader(in.View(), std::cout, json_reader::make_base);
 
-    }
-    else if (mode == "process_requests"sv) {
+        }
+        else if (mode == "process_requests"sv) {
+
+            const io::InputBuffer in = io::InputBuffer::Open("process_requests.json"s);
+            std::ofstream out("result.json"s);
 
-        std::ifstream in("process_requests.json"s);
-        std::ofstream out("result.json"s);
+            json_reader::JsonReader json_reader(in.View(), out, json_reader::process_requests);
 
-        json_reader::JsonReader json_reader(in, out, json_reader::process_requests);
+        }
+        else if (mode == "update_base"sv) {
 
+            const io::InputBuffer in = io::InputBuffer::Open("update_base.json"s);
+            json_reader::JsonReader json_reader(in.View(), std::cout, json_reader::update_base);
+
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
     }
-    else {
-        PrintUsage();
+    catch (const std::exception& error) {
+        // Ошибка входных данных или базы: прежний файл базы при этом не изменён
+        std::cerr << "Error: "sv << error.what() << '\n';
         return 1;
     }
 }
\ No newline at end of file
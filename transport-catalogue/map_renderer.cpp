@@ -20,6 +20,14 @@ namespace map_renderer {
 			(max_lat_ - coords.lat) * zoom_coeff_ + padding_
 		};
 	}
+
+	// Разности целых микроградусов вычисляются точно, масштаб уже учитывает шаг сетки
+	svg::Point SphereProjector::operator()(geo::QuantizedCoordinates coords) const {
+		return {
+			(coords.lng - min_lon_) * zoom_coeff_ + padding_,
+			(max_lat_ - coords.lat) * zoom_coeff_ + padding_
+		};
+	}
 	RendererSettings& RendererSettings::SetWidth(double width) {
 		width_ = std::move(width);
 		
@@ -194,76 +202,100 @@ namespace map_renderer {
 		return settings_;
 	}
 	
-	svg::Document MapRenderer::RenderMap(const domain::BusesMap& routes) {
+	svg::Document MapRenderer::RenderMap(const transport_catalogue::TransportCatalogue& catalogue) const {
 		
 		svg::Document document;
 
-		std::vector<domain::Stop*> all_stops;
-		std::vector<domain::Bus*> all_routes;
+		std::vector<const domain::Bus*> all_routes;
+		// отметки остановок, через которые проходит хотя бы один маршрут, по id остановки
+		std::vector<bool> used_stops(catalogue.GetStopsCount(), false);
 
-		std::vector<geo::Coordinates> stops_coords;
-		svg::Document result;
+		const domain::BusId buses_count = static_cast<domain::BusId>(catalogue.GetBusesCount());
+		for (domain::BusId bus_id = 0; bus_id != buses_count; ++bus_id) {
 
-		for (const auto& [bus_name, bus] : routes) {
-
-			if (bus->stops_.size() == 0) {
+			const auto stop_ids = catalogue.GetBusStopIds(bus_id);
+			if (stop_ids.empty()) {
 				continue;
 			}
 
-			all_routes.push_back(bus);
+			all_routes.push_back(catalogue.GetBusById(bus_id));
 
-			for (const auto& stop : bus->stops_) {
-				stops_coords.push_back(stop->coordinates_);
-				all_stops.push_back(stop);
+			for (const domain::StopId stop_id : stop_ids) {
+				used_stops[stop_id] = true;
+			}
+		}
 
+		std::vector<domain::StopId> all_stops;
+		for (domain::StopId stop_id = 0; stop_id != used_stops.size(); ++stop_id) {
+			if (used_stops[stop_id]) {
+				all_stops.push_back(stop_id);
 			}
 		}
 
 		sort(all_stops.begin(), all_stops.end(),
-			[](domain::Stop* lhs, domain::Stop* rhs) {
-				return lhs->name_ < rhs->name_;
+			[&catalogue](domain::StopId lhs, domain::StopId rhs) {
+				return catalogue.GetStopName(lhs) < catalogue.GetStopName(rhs);
 			});
 		sort(all_routes.begin(), all_routes.end(),
-			[](domain::Bus* lhs, domain::Bus* rhs) {
+			[](const domain::Bus* lhs, const domain::Bus* rhs) {
 				return lhs->bus_name_ < rhs->bus_name_;
 			});
-		
-		const auto last = std::unique(all_stops.begin(), all_stops.end());
-		all_stops.erase(last, all_stops.end());
 
-		SphereProjector projector(stops_coords.begin(), stops_coords.end(), settings_.width_, settings_.height_, settings_.padding_);
+		SphereProjector projector;
+		if (catalogue.IsCoordinatesQuantized()) {
+			std::vector<geo::QuantizedCoordinates> stops_coords;
+			stops_coords.reserve(all_stops.size());
+			for (const domain::StopId stop_id : all_stops) {
+				stops_coords.push_back(catalogue.GetStopQuantizedCoordinates(stop_id));
+			}
+			projector = SphereProjector(stops_coords.begin(), stops_coords.end(), settings_.width_, settings_.height_, settings_.padding_);
+		}
+		else {
+			std::vector<geo::Coordinates> stops_coords;
+			stops_coords.reserve(all_stops.size());
+			for (const domain::StopId stop_id : all_stops) {
+				stops_coords.push_back(catalogue.GetStopCoordinates(stop_id));
+			}
+			projector = SphereProjector(stops_coords.begin(), stops_coords.end(), settings_.width_, settings_.height_, settings_.padding_);
+		}
 		
-		std::vector<svg::Color>& colors = settings_.color_palette_;
+		const std::vector<svg::Color>& colors = settings_.color_palette_;
 		
-		RenderBuses(all_routes, projector, colors, document);
+		RenderBuses(catalogue, all_routes, projector, colors, document);
 		
-		RenderStop(document, all_stops, projector);
-		RenderStopLabels(document, all_stops, projector);
+		RenderStop(document, catalogue, all_stops, projector);
+		RenderStopLabels(document, catalogue, all_stops, projector);
 
 		return document;
 	}
-	void MapRenderer::RenderLine(svg::Polyline& line, svg::Color& color) {
+	svg::Point MapRenderer::ProjectStop(const transport_catalogue::TransportCatalogue& catalogue,
+		const SphereProjector& projector, domain::StopId stop_id) const {
+		return catalogue.IsCoordinatesQuantized()
+			? projector(catalogue.GetStopQuantizedCoordinates(stop_id))
+			: projector(catalogue.GetStopCoordinates(stop_id));
+	}
+	void MapRenderer::RenderLine(svg::Polyline& line, svg::Color& color) const {
 		line.SetFillColor(svg::NoneColor)
 			.SetStrokeColor(color)
 			.SetStrokeWidth(settings_.line_width_)
 			.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
 			.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 	}
-	void MapRenderer::RenderBuses(const std::vector<domain::Bus*>& buses, const SphereProjector& projector,
-		std::vector<svg::Color>& colors, svg::Document& document) {
+	void MapRenderer::RenderBuses(const transport_catalogue::TransportCatalogue& catalogue, const std::vector<const domain::Bus*>& buses,
+		const SphereProjector& projector, const std::vector<svg::Color>& colors, svg::Document& document) const {
 		
 		size_t i = 0;
 
 		svg::Color curr_color;
 		std::vector<svg::Text> labels;
 
-		for (domain::Bus* bus : buses) {
+		for (const domain::Bus* bus : buses) {
 			svg::Polyline line;
-			for (const domain::Stop* stop : bus->stops_) {
-				line.AddPoint(projector(stop->coordinates_));
+			for (const domain::StopId stop_id : catalogue.GetBusStopIds(bus->id_)) {
+				line.AddPoint(ProjectStop(catalogue, projector, stop_id));
 			}
 			curr_color = colors[i % colors.size()];
-			RenderBusLabels(labels, bus, curr_color, projector);
+			RenderBusLabels(labels, catalogue, bus, curr_color, projector);
 			RenderLine(line, curr_color);
 			document.Add(std::move(line));
 			++i;
@@ -272,9 +304,9 @@ namespace map_renderer {
 			document.Add(label);
 		}
 	}
-	void MapRenderer::RenderBusLabel(std::vector<svg::Text>& labels, const svg::Point point, const svg::Color& color, const std::string& route_name) const {
+	void MapRenderer::RenderBusLabel(std::vector<svg::Text>& labels, const svg::Point point, const svg::Color& color, std::string_view route_name) const {
 		labels.push_back(svg::Text()
-			.SetData(route_name)
+			.SetData(std::string(route_name))
 			.SetPosition(point)
 			.SetOffset(settings_.bus_label_offset_)
 			.SetFontSize(settings_.bus_label_font_size_)
@@ -286,7 +318,7 @@ namespace map_renderer {
 			.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
 			.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND));
 		labels.push_back(svg::Text()
-			.SetData(route_name)
+			.SetData(std::string(route_name))
 			.SetPosition(point)
 			.SetOffset(settings_.bus_label_offset_)
 			.SetFontSize(settings_.bus_label_font_size_)
@@ -295,22 +327,24 @@ namespace map_renderer {
 			.SetFillColor(color));
 	}
 
-	void MapRenderer::RenderBusLabels(std::vector<svg::Text>& labels,
+	void MapRenderer::RenderBusLabels(std::vector<svg::Text>& labels, const transport_catalogue::TransportCatalogue& catalogue,
 		const domain::Bus* bus, const svg::Color& color, const SphereProjector& projector) const {
 		
-		size_t m = (bus->stops_.size() / 2);
-		auto first_stop = bus->stops_.front();
+		const auto stop_ids = catalogue.GetBusStopIds(bus->id_);
+		size_t m = (stop_ids.size() / 2);
+		const domain::StopId first_stop = stop_ids[0];
 
-		RenderBusLabel(labels, projector(first_stop->coordinates_), color, bus->bus_name_);
-		if (!bus->is_circular_ && first_stop != bus->stops_[m]) {
-			RenderBusLabel(labels, projector(bus->stops_[m]->coordinates_), color, bus->bus_name_);
+		RenderBusLabel(labels, ProjectStop(catalogue, projector, first_stop), color, bus->bus_name_);
+		if (!bus->is_circular_ && first_stop != stop_ids[m]) {
+			RenderBusLabel(labels, ProjectStop(catalogue, projector, stop_ids[m]), color, bus->bus_name_);
 
 		}
 	}
 
-	void MapRenderer::RenderStop(svg::Document& document, const std::vector<domain::Stop*>& stops, const SphereProjector& projector) const {
-		for (const domain::Stop& stop : stops) {
-			const svg::Point projected_point = projector(stop.coordinates_);
+	void MapRenderer::RenderStop(svg::Document& document, const transport_catalogue::TransportCatalogue& catalogue,
+		const std::vector<domain::StopId>& stops, const SphereProjector& projector) const {
+		for (const domain::StopId stop_id : stops) {
+			const svg::Point projected_point = ProjectStop(catalogue, projector, stop_id);
 			document.Add(svg::Circle()
 				.SetCenter(projected_point)
 				.SetRadius(settings_.stop_radius_)
@@ -318,15 +352,17 @@ namespace map_renderer {
 		}
 	}
 
-	void MapRenderer::RenderStopLabels(svg::Document& document, const std::vector<domain::Stop*>& stops, const SphereProjector& projector) const {
-		for (const domain::Stop& stop : stops) {
-			const svg::Point projected_point = projector(stop.coordinates_);
+	void MapRenderer::RenderStopLabels(svg::Document& document, const transport_catalogue::TransportCatalogue& catalogue,
+		const std::vector<domain::StopId>& stops, const SphereProjector& projector) const {
+		for (const domain::StopId stop_id : stops) {
+			const svg::Point projected_point = ProjectStop(catalogue, projector, stop_id);
+			const std::string stop_name(catalogue.GetStopName(stop_id));
 			document.Add(svg::Text()
 				.SetPosition(projected_point)
 				.SetOffset(settings_.stop_label_offset_)
 				.SetFontSize(settings_.stop_label_font_size_)
 				.SetFontFamily("Verdana"s)
-				.SetData(stop.name_)
+				.SetData(stop_name)
 				.SetFillColor(settings_.underlayer_color_)
 				.SetStrokeColor(settings_.underlayer_color_)
 				.SetStrokeWidth(settings_.underlayer_width_)
@@ -337,7 +373,7 @@ namespace map_renderer {
 				.SetOffset(settings_.stop_label_offset_)
 				.SetFontSize(settings_.stop_label_font_size_)
 				.SetFontFamily("Verdana"s)
-				.SetData(stop.name_)
+				.SetData(stop_name)
 				.SetFillColor("black"s));
 		}
 	}
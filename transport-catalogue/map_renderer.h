@@ -3,6 +3,7 @@
 #include "geo.h"
 #include "svg.h"
 #include "domain.h"
+#include "transport_catalogue.h"
 
 #include <algorithm>
 #include <cstdlib>
@@ -29,6 +30,8 @@ namespace map_renderer {
         SphereProjector(PointInputIt points_begin, PointInputIt points_end, double max_width, double max_height, double padding);
 
         svg::Point operator()(geo::Coordinates coords) const;
+        // Для проектора, построенного по координатам в микроградусах
+        svg::Point operator()(geo::QuantizedCoordinates coords) const;
 
     private:
         double padding_ = 0.0;
@@ -110,7 +113,7 @@ namespace map_renderer {
         const RendererSettings& GetRenderSettings() const;
         RendererSettings& GetRenderSettings();
 
-        svg::Document RenderMap(const domain::BusesMap& routes);
+        svg::Document RenderMap(const transport_catalogue::TransportCatalogue& catalogue) const;
         
         struct BusCompareName {
             bool operator()(const domain::Bus* lhs, const domain::Bus* rhs) const {
@@ -127,17 +130,21 @@ namespace map_renderer {
 
         void RenderRoutes(svg::Document& document, const RoutesPoints& projected_points, std::vector<svg::Color>& colors) const;
   
-        void RenderBusLabels(std::vector<svg::Text>& labels,
+        void RenderBusLabels(std::vector<svg::Text>& labels, const transport_catalogue::TransportCatalogue& catalogue,
             const domain::Bus* bus, const svg::Color& color, const SphereProjector& projector) const;
 
-        void RenderBusLabel(std::vector<svg::Text>& labels, const svg::Point point, const svg::Color& color, const std::string& route_name) const;
+        void RenderBusLabel(std::vector<svg::Text>& labels, const svg::Point point, const svg::Color& color, std::string_view route_name) const;
 
-        void RenderStop(svg::Document& document, const std::vector<domain::Stop*>& stops, const SphereProjector& projector) const;
+        void RenderStop(svg::Document& document, const transport_catalogue::TransportCatalogue& catalogue,
+            const std::vector<domain::StopId>& stops, const SphereProjector& projector) const;
 
-        void RenderStopLabels(svg::Document& document, const std::vector<domain::Stop*>& stops, const SphereProjector& projector) const;
-        void RenderLine(svg::Polyline& line, svg::Color& color);
-        void RenderBuses(const std::vector<domain::Bus*>& buses, const SphereProjector& projector,
-            std::vector<svg::Color>& colors, svg::Document& document);
+        void RenderStopLabels(svg::Document& document, const transport_catalogue::TransportCatalogue& catalogue,
+            const std::vector<domain::StopId>& stops, const SphereProjector& projector) const;
+        void RenderLine(svg::Polyline& line, svg::Color& color) const;
+        svg::Point ProjectStop(const transport_catalogue::TransportCatalogue& catalogue,
+            const SphereProjector& projector, domain::StopId stop_id) const;
+        void RenderBuses(const transport_catalogue::TransportCatalogue& catalogue, const std::vector<const domain::Bus*>& buses,
+            const SphereProjector& projector, const std::vector<svg::Color>& colors, svg::Document& document) const;
         
     };
 
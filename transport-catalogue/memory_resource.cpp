@@ -0,0 +1,66 @@
+#include "memory_resource.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace memory {
+
+    void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+        void* ptr = upstream_->allocate(bytes, alignment);
+
+        ++counters_.allocations;
+        counters_.allocated_bytes += bytes;
+        counters_.used_bytes += bytes;
+        counters_.peak_bytes = std::max(counters_.peak_bytes, counters_.used_bytes);
+        return ptr;
+    }
+
+    void CountingResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+        upstream_->deallocate(ptr, bytes, alignment);
+
+        ++counters_.deallocations;
+        counters_.used_bytes -= bytes;
+    }
+
+    bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    IngestionArena::IngestionArena()
+        : upstream_(std::pmr::new_delete_resource())
+        , arena_(INGESTION_ARENA_INITIAL_SIZE, &upstream_) {
+    }
+
+    size_t GetPeakRss() {
+        std::ifstream status("/proc/self/status"s);
+        if (!status) {
+            return 0U;
+        }
+
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("VmHWM:"s, 0) == 0) {
+                std::istringstream field(line.substr(6));
+                size_t kb = 0;
+                field >> kb;
+                return kb * 1024U;
+            }
+        }
+        return 0U;
+    }
+
+    void PrintResourceCounters(std::ostream& out, const ResourceCounters& counters) {
+        out << "memory resource: allocations="sv << counters.allocations
+            << " deallocations="sv << counters.deallocations
+            << " allocated_bytes="sv << counters.allocated_bytes
+            << " used_bytes="sv << counters.used_bytes
+            << " peak_bytes="sv << counters.peak_bytes
+            << " peak_rss="sv << GetPeakRss() << '\n';
+    }
+
+}  // namespace memory
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+
+namespace memory {
+
+    // Первый блок арены make_base; дальше монотонный ресурс растит блоки геометрически
+    constexpr size_t INGESTION_ARENA_INITIAL_SIZE = 1U * 1024U * 1024U;
+
+    struct ResourceCounters {
+        size_t allocations = 0U;        // вызовов do_allocate
+        size_t deallocations = 0U;      // вызовов do_deallocate
+        size_t allocated_bytes = 0U;    // байт выделено за всё время
+        size_t used_bytes = 0U;         // байт занято сейчас
+        size_t peak_bytes = 0U;         // максимум used_bytes
+    };
+
+    // Пропускает выделения в вышестоящий ресурс и считает их.
+    // Не потокобезопасен, как и monotonic_buffer_resource, поверх которого используется
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+            : upstream_(upstream) {
+        }
+
+        std::pmr::memory_resource* GetUpstream() const noexcept {
+            return upstream_;
+        }
+
+        const ResourceCounters& GetCounters() const noexcept {
+            return counters_;
+        }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        std::pmr::memory_resource* upstream_;
+        ResourceCounters counters_;
+    };
+
+    // Арена на время сборки базы: выделения - сдвиг указателя, освобождение - разом в деструкторе.
+    // Блоки арены берутся через счётчик, чтобы было видно, сколько памяти она запросила
+    class IngestionArena {
+    public:
+        IngestionArena();
+
+        IngestionArena(const IngestionArena&) = delete;
+        IngestionArena& operator=(const IngestionArena&) = delete;
+
+        std::pmr::memory_resource* GetResource() noexcept {
+            return &arena_;
+        }
+
+        const ResourceCounters& GetCounters() const noexcept {
+            return upstream_.GetCounters();
+        }
+
+    private:
+        CountingResource upstream_;
+        std::pmr::monotonic_buffer_resource arena_;
+    };
+
+    // Пиковый резидентный объём процесса (VmHWM из /proc/self/status), 0 - если недоступен
+    size_t GetPeakRss();
+
+    void PrintResourceCounters(std::ostream& out, const ResourceCounters& counters);
+
+}  // namespace memory
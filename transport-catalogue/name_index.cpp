@@ -0,0 +1,279 @@
+#include "name_index.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace search {
+
+    namespace {
+
+        constexpr size_t NPOS = static_cast<size_t>(-1);
+
+        bool IsContinuation(char c) {
+            return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+        }
+
+        // Символ UTF-8 с позиции pos; некорректный байт возвращается как есть и занимает один байт
+        char32_t Decode(std::string_view text, size_t& pos) {
+            const unsigned char lead = static_cast<unsigned char>(text[pos]);
+            const size_t length = lead < 0x80 ? 1U
+                : (lead >> 5) == 0x6 ? 2U
+                : (lead >> 4) == 0xE ? 3U
+                : (lead >> 3) == 0x1E ? 4U
+                : 1U;
+            if (length == 1 || pos + length > text.size()) {
+                ++pos;
+                return lead;
+            }
+
+            char32_t code = lead & (0x7F >> length);
+            for (size_t i = 1; i != length; ++i) {
+                if (!IsContinuation(text[pos + i])) {
+                    ++pos;
+                    return lead;
+                }
+                code = (code << 6) | (static_cast<unsigned char>(text[pos + i]) & 0x3F);
+            }
+            pos += length;
+            return code;
+        }
+
+        void Encode(char32_t code, std::string& out) {
+            if (code < 0x80) {
+                out.push_back(static_cast<char>(code));
+            }
+            else if (code < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else if (code < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else {
+                out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+
+        char32_t Fold(char32_t code) {
+            if (code >= U'A' && code <= U'Z') {
+                return code + (U'a' - U'A');
+            }
+            // А-Я -> а-я
+            if (code >= 0x0410 && code <= 0x042F) {
+                return code + 0x20;
+            }
+            // Ё, ё -> е
+            if (code == 0x0401 || code == 0x0451) {
+                return 0x0435;
+            }
+            return code;
+        }
+
+        // Общий префикс в байтах, укороченный до границы символа
+        uint32_t CommonPrefix(std::string_view lhs, std::string_view rhs) {
+            size_t length = std::mismatch(lhs.begin(), lhs.begin() + std::min(lhs.size(), rhs.size()), rhs.begin()).first - lhs.begin();
+            while (length != 0
+                && ((length < lhs.size() && IsContinuation(lhs[length])) || (length < rhs.size() && IsContinuation(rhs[length])))) {
+                --length;
+            }
+            return static_cast<uint32_t>(length);
+        }
+
+    }  // namespace
+
+    std::string NameIndex::Normalize(std::string_view name) {
+        std::string result;
+        result.reserve(name.size());
+
+        size_t pos = 0;
+        while (pos != name.size()) {
+            const size_t start = pos;
+            const char32_t code = Decode(name, pos);
+            const char32_t folded = Fold(code);
+            if (folded == code) {
+                result.append(name.substr(start, pos - start));
+            }
+            else {
+                Encode(folded, result);
+            }
+        }
+        return result;
+    }
+
+    void NameIndex::Build(const std::vector<std::string_view>& names) {
+        std::vector<std::string> keys;
+        keys.reserve(names.size());
+        for (const std::string_view name : names) {
+            keys.push_back(Normalize(name));
+        }
+
+        std::vector<uint32_t> order(names.size());
+        std::iota(order.begin(), order.end(), 0U);
+        std::sort(order.begin(), order.end(), [&keys](uint32_t lhs, uint32_t rhs) {
+            return keys[lhs] < keys[rhs] || (keys[lhs] == keys[rhs] && lhs < rhs);
+        });
+
+        Assign(std::move(order), keys);
+    }
+
+    bool NameIndex::Restore(std::vector<uint32_t>&& order, const std::vector<std::string_view>& names) {
+        order_.clear();
+        keys_.clear();
+        offsets_.clear();
+        lcp_.clear();
+        if (order.size() != names.size()) {
+            return false;
+        }
+
+        std::vector<bool> seen(names.size(), false);
+        for (const uint32_t id : order) {
+            if (id >= names.size() || seen[id]) {
+                return false;
+            }
+            seen[id] = true;
+        }
+
+        std::vector<std::string> keys;
+        keys.reserve(names.size());
+        for (const std::string_view name : names) {
+            keys.push_back(Normalize(name));
+        }
+        // Нормализация могла измениться с момента записи базы - тогда порядок недействителен
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (keys[order[i]] < keys[order[i - 1]]) {
+                return false;
+            }
+        }
+
+        Assign(std::move(order), keys);
+        return true;
+    }
+
+    void NameIndex::Assign(std::vector<uint32_t>&& order, const std::vector<std::string>& keys) {
+        order_ = std::move(order);
+
+        size_t total = 0;
+        for (const std::string& key : keys) {
+            total += key.size();
+        }
+        keys_.clear();
+        keys_.reserve(total);
+        offsets_.assign(1, 0U);
+        offsets_.reserve(order_.size() + 1);
+        for (const uint32_t id : order_) {
+            keys_ += keys[id];
+            offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+        }
+
+        lcp_.assign(order_.size(), 0U);
+        for (size_t i = 1; i < order_.size(); ++i) {
+            lcp_[i] = CommonPrefix(GetKey(i - 1), GetKey(i));
+        }
+    }
+
+    std::vector<Match> NameIndex::FindPrefix(std::string_view prefix) const {
+        const std::string key = Normalize(prefix);
+
+        // Имена с префиксом - отрезок, начинающийся с первого имени не меньше префикса
+        size_t first = 0;
+        size_t last = order_.size();
+        while (first < last) {
+            const size_t mid = first + (last - first) / 2;
+            if (GetKey(mid) < key) {
+                first = mid + 1;
+            }
+            else {
+                last = mid;
+            }
+        }
+        last = order_.size();
+        size_t end = first;
+        while (end < last) {
+            const size_t mid = end + (last - end) / 2;
+            if (GetKey(mid).substr(0, key.size()) == key) {
+                end = mid + 1;
+            }
+            else {
+                last = mid;
+            }
+        }
+
+        std::vector<Match> result;
+        result.reserve(end - first);
+        for (size_t i = first; i != end; ++i) {
+            result.push_back({ order_[i], 0U });
+        }
+        return result;
+    }
+
+    std::vector<Match> NameIndex::FindFuzzyPrefix(std::string_view prefix, size_t max_edits) const {
+        max_edits = std::min(max_edits, MAX_EDITS);
+        if (max_edits == 0) {
+            return FindPrefix(prefix);
+        }
+
+        const std::string key = Normalize(prefix);
+        std::u32string query;
+        for (size_t pos = 0; pos != key.size();) {
+            query.push_back(Decode(key, pos));
+        }
+        const size_t width = query.size() + 1;
+
+        // Строка d таблицы - расстояния от первых d символов имени до каждого префикса запроса.
+        // ends[d] - байтовая граница d символов имени, best[d] - минимум по строкам 0..d
+        // расстояния до всего запроса, dead - первая строка, где все значения больше max_edits:
+        // дальше они только растут, и продолжения имени уже не совпадут
+        std::vector<uint32_t> rows(width);
+        std::iota(rows.begin(), rows.end(), 0U);
+        std::vector<uint32_t> ends = { 0U };
+        std::vector<uint32_t> best = { static_cast<uint32_t>(query.size()) };
+        size_t dead = NPOS;
+
+        std::vector<Match> result;
+        for (size_t i = 0; i != order_.size(); ++i) {
+            const std::string_view name = GetKey(i);
+
+            // Строки общего с предыдущим именем префикса остаются в силе
+            const size_t shared = static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), lcp_[i]) - ends.begin()) - 1;
+            rows.resize((shared + 1) * width);
+            ends.resize(shared + 1);
+            best.resize(shared + 1);
+            if (dead != NPOS && dead > shared) {
+                dead = NPOS;
+            }
+
+            size_t pos = ends.back();
+            while (dead == NPOS && pos != name.size()) {
+                const char32_t code = Decode(name, pos);
+                const size_t depth = ends.size();
+                rows.resize((depth + 1) * width);
+                const uint32_t* previous = rows.data() + (depth - 1) * width;
+                uint32_t* row = rows.data() + depth * width;
+
+                row[0] = static_cast<uint32_t>(depth);
+                uint32_t row_min = row[0];
+                for (size_t j = 1; j != width; ++j) {
+                    row[j] = std::min({ previous[j] + 1, row[j - 1] + 1, previous[j - 1] + (query[j - 1] != code ? 1U : 0U) });
+                    row_min = std::min(row_min, row[j]);
+                }
+
+                ends.push_back(static_cast<uint32_t>(pos));
+                best.push_back(std::min(best.back(), row[width - 1]));
+                if (row_min > max_edits) {
+                    dead = depth;
+                }
+            }
+
+            if (best.back() <= max_edits) {
+                result.push_back({ order_[i], best.back() });
+            }
+        }
+        return result;
+    }
+
+}  // namespace search
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace search {
+
+    struct Match {
+        uint32_t id = 0U;
+        uint32_t edits = 0U;    // правок до совпадения с префиксом имени
+    };
+
+    // Индекс имён для поиска по префиксу: нормализованные имена отсортированы и лежат подряд
+    // в одном буфере, рядом - длины общих префиксов соседей (LCP). Точный префикс - отрезок
+    // отсортированного массива, нечёткий поиск обходит массив как бор: строки таблицы
+    // редакционного расстояния для общего с предыдущим именем префикса не пересчитываются
+    class NameIndex {
+    public:
+        // Больше правок на коротких префиксах совпадает почти со всем
+        static constexpr size_t MAX_EDITS = 2U;
+
+        NameIndex() = default;
+
+        // names индексируются id
+        void Build(const std::vector<std::string_view>& names);
+        // Порядок id из базы; false - это не перестановка или имена в нём не отсортированы, индекс пуст
+        bool Restore(std::vector<uint32_t>&& order, const std::vector<std::string_view>& names);
+
+        // Имена, начинающиеся с prefix, в порядке индекса
+        std::vector<Match> FindPrefix(std::string_view prefix) const;
+        // Имена, у которых некоторый префикс отличается от prefix не более чем на max_edits
+        // вставок, удалений и замен символов; max_edits ограничивается MAX_EDITS
+        std::vector<Match> FindFuzzyPrefix(std::string_view prefix, size_t max_edits) const;
+
+        const std::vector<uint32_t>& GetOrder() const {
+            return order_;
+        }
+
+        size_t size() const {
+            return order_.size();
+        }
+
+        // Нижний регистр для латиницы и кириллицы, ё приравнивается к е. Остальное без изменений
+        static std::string Normalize(std::string_view name);
+
+    private:
+        std::string_view GetKey(size_t position) const {
+            return std::string_view(keys_).substr(offsets_[position], offsets_[position + 1] - offsets_[position]);
+        }
+
+        void Assign(std::vector<uint32_t>&& order, const std::vector<std::string>& keys);
+
+        std::vector<uint32_t> order_;
+        // Нормализованные имена в порядке order_ одной строкой: имя i - [offsets_[i], offsets_[i + 1])
+        std::string keys_;
+        std::vector<uint32_t> offsets_;
+        // Общий префикс имени i с именем i - 1 в байтах, по границе символа UTF-8
+        std::vector<uint32_t> lcp_;
+    };
+
+}  // namespace search
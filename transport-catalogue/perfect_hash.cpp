@@ -0,0 +1,152 @@
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace perfect_hash {
+
+    namespace {
+
+        // Сколько смещений перебирается для одной корзины, прежде чем сменить зерно
+        constexpr uint32_t MAX_DISPLACEMENT = 1U << 20;
+        constexpr int MAX_SEEDS = 16;
+
+        uint64_t Mix(uint64_t value) {
+            // финализатор splitmix64
+            value ^= value >> 30;
+            value *= 0xBF58476D1CE4E5B9ULL;
+            value ^= value >> 27;
+            value *= 0x94D049BB133111EBULL;
+            value ^= value >> 31;
+            return value;
+        }
+
+    }  // namespace
+
+    MinimalPerfectHash::MinimalPerfectHash(uint64_t seed, std::vector<uint32_t> displacements,
+        std::vector<uint32_t> slots, std::vector<uint16_t> fingerprints)
+        : seed_(seed)
+        , displacements_(std::move(displacements))
+        , slots_(std::move(slots))
+        , fingerprints_(std::move(fingerprints)) {
+    }
+
+    void MinimalPerfectHash::Build(const std::vector<std::string_view>& keys) {
+        for (int attempt = 0; attempt != MAX_SEEDS; ++attempt) {
+            seed_ = Mix(static_cast<uint64_t>(attempt) + 1);
+            if (TryBuild(keys)) {
+                return;
+            }
+        }
+        // Такое возможно только при повторяющихся ключах - оставляем функцию пустой,
+        // поиск тогда выполняется без неё
+        displacements_.clear();
+        slots_.clear();
+        fingerprints_.clear();
+    }
+
+    std::optional<uint32_t> MinimalPerfectHash::Lookup(std::string_view key) const {
+        if (slots_.empty()) {
+            return std::nullopt;
+        }
+        const uint64_t hash = Hash(key, seed_);
+        const size_t slot = Slot(hash, displacements_[Bucket(hash)]);
+        if (fingerprints_[slot] != Fingerprint(hash)) {
+            return std::nullopt;
+        }
+        return slots_[slot];
+    }
+
+    size_t MinimalPerfectHash::GetMemoryUsage() const {
+        return displacements_.capacity() * sizeof(uint32_t)
+            + slots_.capacity() * sizeof(uint32_t)
+            + fingerprints_.capacity() * sizeof(uint16_t);
+    }
+
+    uint64_t MinimalPerfectHash::Hash(std::string_view key, uint64_t seed) {
+        // FNV-1a с зерном и последующим перемешиванием: результат не зависит
+        // от реализации std::hash, поэтому функцию можно сохранять в базу
+        uint64_t hash = 0xCBF29CE484222325ULL ^ seed;
+        for (const char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001B3ULL;
+        }
+        return Mix(hash);
+    }
+
+    uint16_t MinimalPerfectHash::Fingerprint(uint64_t hash) {
+        return static_cast<uint16_t>(hash);
+    }
+
+    size_t MinimalPerfectHash::Bucket(uint64_t hash) const {
+        return static_cast<size_t>((hash >> 32) % displacements_.size());
+    }
+
+    size_t MinimalPerfectHash::Slot(uint64_t hash, uint32_t displacement) const {
+        return static_cast<size_t>(Mix(hash + displacement * 0x9E3779B97F4A7C15ULL) % slots_.size());
+    }
+
+    bool MinimalPerfectHash::TryBuild(const std::vector<std::string_view>& keys) {
+        const size_t keys_count = keys.size();
+        const size_t buckets_count = std::max<size_t>(1U, (keys_count + BUCKET_SIZE - 1) / BUCKET_SIZE);
+
+        displacements_.assign(buckets_count, 0U);
+        slots_.assign(keys_count, 0U);
+        fingerprints_.assign(keys_count, 0U);
+        if (keys_count == 0) {
+            return true;
+        }
+
+        std::vector<uint64_t> hashes(keys_count);
+        std::vector<std::vector<uint32_t>> buckets(buckets_count);
+        for (size_t i = 0; i != keys_count; ++i) {
+            hashes[i] = Hash(keys[i], seed_);
+            buckets[Bucket(hashes[i])].push_back(static_cast<uint32_t>(i));
+        }
+
+        // Большие корзины размещаются первыми, пока свободных ячеек много
+        std::vector<uint32_t> order(buckets_count);
+        std::iota(order.begin(), order.end(), 0U);
+        std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t lhs, uint32_t rhs) {
+            return buckets[lhs].size() > buckets[rhs].size();
+            });
+
+        std::vector<bool> taken(keys_count, false);
+        std::vector<size_t> candidate_slots;
+        for (const uint32_t bucket_id : order) {
+            const std::vector<uint32_t>& bucket = buckets[bucket_id];
+            if (bucket.empty()) {
+                break;
+            }
+
+            bool placed = false;
+            for (uint32_t displacement = 0; displacement != MAX_DISPLACEMENT && !placed; ++displacement) {
+                candidate_slots.clear();
+                placed = true;
+                for (const uint32_t key_id : bucket) {
+                    const size_t slot = Slot(hashes[key_id], displacement);
+                    if (taken[slot] || std::find(candidate_slots.begin(), candidate_slots.end(), slot) != candidate_slots.end()) {
+                        placed = false;
+                        break;
+                    }
+                    candidate_slots.push_back(slot);
+                }
+                if (placed) {
+                    displacements_[bucket_id] = displacement;
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+
+            for (size_t i = 0; i != bucket.size(); ++i) {
+                const size_t slot = candidate_slots[i];
+                taken[slot] = true;
+                slots_[slot] = bucket[i];
+                fingerprints_[slot] = Fingerprint(hashes[bucket[i]]);
+            }
+        }
+        return true;
+    }
+
+}  // namespace perfect_hash
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace perfect_hash {
+
+    // Минимальная совершенная хеш-функция по схеме CHD (hash and displace):
+    // ключи раскладываются по корзинам, для каждой корзины подбирается смещение,
+    // при котором все её ключи попадают в свободные ячейки. n ключей занимают ровно n ячеек.
+    // В ячейке хранится индекс ключа и 16-битный отпечаток, по которому
+    // отсекается подавляющее большинство неизвестных ключей без сравнения строк
+    class MinimalPerfectHash {
+    public:
+        // Среднее количество ключей в корзине
+        static constexpr size_t BUCKET_SIZE = 4U;
+
+        MinimalPerfectHash() = default;
+        MinimalPerfectHash(uint64_t seed, std::vector<uint32_t> displacements,
+            std::vector<uint32_t> slots, std::vector<uint16_t> fingerprints);
+
+        // Строит функцию над набором различных ключей, ключ keys[i] получает индекс i
+        void Build(const std::vector<std::string_view>& keys);
+
+        // Индекс ключа-кандидата с совпавшим отпечатком. Функция не хранит ключи,
+        // поэтому вызывающий должен сравнить найденный ключ с искомым
+        std::optional<uint32_t> Lookup(std::string_view key) const;
+
+        size_t size() const {
+            return slots_.size();
+        }
+        bool empty() const {
+            return slots_.empty();
+        }
+
+        uint64_t GetSeed() const {
+            return seed_;
+        }
+        const std::vector<uint32_t>& GetDisplacements() const {
+            return displacements_;
+        }
+        const std::vector<uint32_t>& GetSlots() const {
+            return slots_;
+        }
+        const std::vector<uint16_t>& GetFingerprints() const {
+            return fingerprints_;
+        }
+
+        size_t GetMemoryUsage() const;
+
+    private:
+        static uint64_t Hash(std::string_view key, uint64_t seed);
+        static uint16_t Fingerprint(uint64_t hash);
+        size_t Bucket(uint64_t hash) const;
+        size_t Slot(uint64_t hash, uint32_t displacement) const;
+
+        bool TryBuild(const std::vector<std::string_view>& keys);
+
+        uint64_t seed_ = 0U;
+        std::vector<uint32_t> displacements_;
+        std::vector<uint32_t> slots_;
+        std::vector<uint16_t> fingerprints_;
+    };
+
+}  // namespace perfect_hash
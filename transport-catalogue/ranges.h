@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 #include <string_view>
 #include <unordered_map>
@@ -22,12 +23,113 @@ namespace ranges {
         It end() const {
             return end_;
         }
+        size_t size() const {
+            return static_cast<size_t>(std::distance(begin_, end_));
+        }
+        bool empty() const {
+            return begin_ == end_;
+        }
+        decltype(auto) operator[](size_t index) const {
+            return begin_[index];
+        }
 
     private:
         It begin_;
         It end_;
     };
 
+    // Маршрут, который хранится один раз, а проходится как [begin, end) и обратно до begin.
+    // Для кольцевого маршрута обратного хода нет. Обратный ход не материализуется:
+    // позиция i >= n отображается на элемент 2n - 2 - i
+    template <typename It>
+    class RouteRange {
+    public:
+        using ValueType = typename std::iterator_traits<It>::value_type;
+
+        class Iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = typename std::iterator_traits<It>::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = typename std::iterator_traits<It>::pointer;
+            using reference = typename std::iterator_traits<It>::reference;
+
+            Iterator(It begin, size_t stored, size_t pos)
+                : begin_(begin)
+                , stored_(stored)
+                , pos_(pos) {
+            }
+
+            reference operator*() const {
+                return begin_[pos_ < stored_ ? pos_ : 2 * stored_ - 2 - pos_];
+            }
+            Iterator& operator++() {
+                ++pos_;
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator old = *this;
+                ++pos_;
+                return old;
+            }
+            Iterator& operator--() {
+                --pos_;
+                return *this;
+            }
+            Iterator operator--(int) {
+                Iterator old = *this;
+                --pos_;
+                return old;
+            }
+            bool operator==(const Iterator& other) const {
+                return pos_ == other.pos_;
+            }
+            bool operator!=(const Iterator& other) const {
+                return pos_ != other.pos_;
+            }
+
+        private:
+            It begin_;
+            size_t stored_;
+            size_t pos_;
+        };
+
+        RouteRange(It begin, It end, bool is_circular)
+            : begin_(begin)
+            , stored_(static_cast<size_t>(std::distance(begin, end)))
+            , is_circular_(is_circular) {
+        }
+
+        Iterator begin() const {
+            return { begin_, stored_, 0U };
+        }
+        Iterator end() const {
+            return { begin_, stored_, size() };
+        }
+        size_t size() const {
+            return is_circular_ || stored_ == 0 ? stored_ : 2 * stored_ - 1;
+        }
+        bool empty() const {
+            return stored_ == 0;
+        }
+        decltype(auto) operator[](size_t index) const {
+            return begin_[index < stored_ ? index : 2 * stored_ - 2 - index];
+        }
+
+        // Остановки в том виде, в каком они хранятся - без обратного хода
+        Range<It> GetStored() const {
+            return { begin_, begin_ + stored_ };
+        }
+        bool IsCircular() const {
+            return is_circular_;
+        }
+
+    private:
+        It begin_;
+        size_t stored_;
+        bool is_circular_;
+    };
+
     template <typename C>
     auto AsRange(const C& container) {
         return Range{ container.begin(), container.end() };
@@ -1,6 +1,11 @@
 #include "request_handler.h"
 #include "transport_catalogue.h"
 
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
 namespace request_handler {
 
 	void RequestHandler::InitializeMapRenderer()
@@ -13,58 +18,58 @@ namespace request_handler {
 	void RequestHandler::InitializeRouter()
 	{
 		if (!transport_router_) {
-			transport_router_ = std::make_unique<transport_catalogue::router::TransportRouter>(transport_catalogue_, router_settings_);
+			transport_router_ = std::make_shared<transport_catalogue::router::TransportRouter>(*transport_catalogue_, router_settings_, resource_);
 		}
 	}
 
-	svg::Document RequestHandler::RenderMap()
-	{
-		InitializeMapRenderer();
-
-		return map_renderer_.get()->RenderMap(transport_catalogue_.GetBusesMap());
-	}
-
-	const std::string RequestHandler::GetMap()
-	{
-		std::ostringstream strm;
-		RenderMap().Render(strm);
-
-		return strm.str();
-	}
-
 	void RequestHandler::SetMapRenderSettings(map_renderer::RendererSettings&& settings)
 	{
 		renderer_settings_ = std::move(settings);
 
-		InitializeMapRenderer();
-
-		map_renderer_.get()->SetSettings(renderer_settings_);
+		// Отрисовщик мог попасть в снимок, поэтому новые настройки получает новый объект
+		map_renderer_ = std::make_shared<map_renderer::MapRenderer>(renderer_settings_);
 	}
 
 	void RequestHandler::SetRouterSettings(transport_catalogue::router::RouterSettings&& settings)
 	{
 		router_settings_ = std::move(settings);
 
+		if (router_published_) {
+			transport_router_ = nullptr;
+			router_published_ = false;
+		}
 		InitializeRouter();
 
 		transport_router_.get()->SetRouterSettings(router_settings_);
 	}
 
+	void RequestHandler::SetCoordinatesQuantization(bool quantized)
+	{
+		DetachCatalogue();
+		transport_catalogue_->SetCoordinatesQuantization(quantized);
+	}
+
+	void RequestHandler::SetMemoryResource(std::pmr::memory_resource* resource)
+	{
+		resource_ = resource;
+	}
+
 	void RequestHandler::InitializeTransportRouterGraph()
 	{
 		transport_router_->ImportRoutingDataFromCatalogue();
 	}
 
 	domain::Stop RequestHandler::MakeStop(domain::Request& request) {
-		return { std::string(request.name_), request.coordinates_.lat, request.coordinates_.lng };
+		return { request.name_, request.coordinates_.lat, request.coordinates_.lng };
 	}
 
 	domain::Bus RequestHandler::MakeBus(domain::Request& request) {
-		domain::Bus result;
+		domain::Bus result(resource_);
 		result.is_circular_ = request.is_circular_;
 		result.bus_name_ = request.name_;
-		for (const std::string& stop : request.stops_) {
-			result.stops_.push_back(transport_catalogue_.FindStopByName(stop));
+		result.stops_.reserve(request.stops_.size());
+		for (const std::pmr::string& stop : request.stops_) {
+			result.stops_.push_back(transport_catalogue_->FindStopByName(stop));
 		}
 		return result;
 	}
@@ -72,45 +77,161 @@ namespace request_handler {
 	void RequestHandler::ProcessDistances() {
 		if (map_distances_.size() != 0) {
 			for (auto& [first_stop, distances] : map_distances_) {
-				domain::Stop* first_stop_ptr = transport_catalogue_.FindStopByName(first_stop);
-				for (auto& dist : distances) {
-					transport_catalogue_.AddStopsDistance(first_stop_ptr, transport_catalogue_.FindStopByName(dist.first), dist.second);
+				domain::Stop* first_stop_ptr = transport_catalogue_->FindStopByName(first_stop);
+				for (auto& dist : *distances) {
+					transport_catalogue_->AddStopsDistance(first_stop_ptr, transport_catalogue_->FindStopByName(dist.first), dist.second);
 				}
 			}
 		}
 	}
 
-	void RequestHandler::AddStops(std::vector<domain::Request>& requests)
+	void RequestHandler::AddStops(domain::RequestsList& requests)
 	{
+		DetachCatalogue();
 		for (domain::Request& request : requests) {
-			transport_catalogue_.AddStop(MakeStop(request));
+			transport_catalogue_->AddStop(MakeStop(request));
 			if (!request.distances_.empty()) {
-				map_distances_[std::move(request.name_)] = std::move(request.distances_);
+				map_distances_[request.name_] = &request.distances_;
 			}
 		}
 		ProcessDistances();
+		map_distances_.clear();
+		// Новые остановки и расстояния - граф строится заново целиком
+		previous_router_ = nullptr;
 	}
 
-	void RequestHandler::AddBuses(std::vector<domain::Request>& requests)
+	void RequestHandler::AddBuses(domain::RequestsList& requests)
 	{
+		DetachCatalogue();
+		std::vector<domain::Bus> buses;
+		buses.reserve(requests.size());
 		for (domain::Request& request : requests) {
-			transport_catalogue_.AddBus(std::move(MakeBus(request)));
+			buses.push_back(MakeBus(request));
+		}
+		transport_catalogue_->AddBuses(std::move(buses));
+		previous_router_ = nullptr;
+	}
+
+	void RequestHandler::HandleUpdateRequests(domain::RequestsList& requests)
+	{
+		DetachCatalogue();
+		// Граф маршрутизатора построен по этому же каталогу до изменений - перенести из него нечего
+		if (!rebuild_router_ && transport_router_) {
+			transport_router_ = nullptr;
+			rebuild_router_ = true;
+		}
+
+		for (const domain::Request& request : requests) {
+			switch (request.type_) {
+			case domain::RequestType::update_stop_coordinates:
+				// рёбра графа от координат не зависят
+				transport_catalogue_->UpdateStopCoordinates(FindUpdatedStop(request.name_), request.coordinates_);
+				break;
+			case domain::RequestType::set_road_distance: {
+				domain::Stop* from_stop = FindUpdatedStop(request.name_);
+				for (const auto& [to_stop, distance] : request.distances_) {
+					if (distance < 0 || static_cast<uint64_t>(distance) > std::numeric_limits<uint32_t>::max()) {
+						throw std::out_of_range("Road distance out of range: " + std::to_string(distance));
+					}
+					MarkChangedBuses(transport_catalogue_->SetStopsDistance(
+						from_stop, FindUpdatedStop(to_stop), static_cast<size_t>(distance)));
+				}
+				break;
+			}
+			case domain::RequestType::add_stop_to_bus: {
+				domain::Bus* bus = transport_catalogue_->FindRouteByName(request.name_);
+				if (bus == nullptr) {
+					throw std::invalid_argument("Unknown bus in update request: " + std::string(request.name_));
+				}
+				if (request.stops_.empty()) {
+					throw std::invalid_argument("No stop to add to bus " + std::string(request.name_));
+				}
+				domain::Stop* stop = FindUpdatedStop(request.stops_.front());
+				if (!transport_catalogue_->AddStopToBus(bus, stop, request.position_)) {
+					throw std::out_of_range("Stop position out of range for bus " + std::string(request.name_));
+				}
+				MarkChangedBuses({ bus->id_ });
+				break;
+			}
+			default:
+				break;
+			}
 		}
 	}
 
-	domain::StopStat* RequestHandler::GetStop(const std::string_view stop)
+	domain::Stop* RequestHandler::FindUpdatedStop(std::string_view name) const
 	{
-		return transport_catalogue_.GetBusesForStopInfo(stop);
+		domain::Stop* stop = transport_catalogue_->FindStopByName(name);
+		if (stop == nullptr) {
+			throw std::invalid_argument("Unknown stop in update request: " + std::string(name));
+		}
+		return stop;
 	}
 
-	domain::BusStat* RequestHandler::GetBus(const std::string_view route)
+	void RequestHandler::MarkChangedBuses(const domain::BusIdsList& bus_ids)
 	{
-		return transport_catalogue_.GetBusInfo(route);
+		for (const domain::BusId id : bus_ids) {
+			if (id < changed_buses_.size()) {
+				changed_buses_[id] = true;
+			}
+		}
 	}
 
-	domain::RouteStat RequestHandler::GetRoute(const std::string_view from, const std::string_view to)
+	void RequestHandler::DetachCatalogue()
 	{
-		return transport_router_.get()->MakeRoute(from, to);
+		if (!catalogue_published_) {
+			return;
+		}
+		// Прежние каталог и маршрутизатор живут до перестроения графа: из них переносятся
+		// рёбра маршрутов, которые изменения не затронут
+		previous_catalogue_ = transport_catalogue_;
+		previous_router_ = transport_router_;
+		changed_buses_.assign(transport_catalogue_->GetBusesCount(), false);
+
+		transport_catalogue_ = transport_catalogue_->Clone();
+		catalogue_published_ = false;
+
+		// Маршрутизатор и сериализатор ссылаются на прежний каталог
+		rebuild_router_ = rebuild_router_ || transport_router_ != nullptr;
+		transport_router_ = nullptr;
+		router_published_ = false;
+		serializer_ = nullptr;
+	}
+
+	std::shared_ptr<const transport_catalogue::snapshot::CatalogueSnapshot> RequestHandler::GetSnapshot() const
+	{
+		return versions_.Acquire();
+	}
+
+	void RequestHandler::RebuildRouter()
+	{
+		if (!rebuild_router_) {
+			return;
+		}
+		InitializeRouter();
+		if (previous_router_) {
+			transport_router_->ImportRoutingDataFromPrevious(*previous_router_, changed_buses_);
+		}
+		previous_router_ = nullptr;
+		previous_catalogue_ = nullptr;
+		changed_buses_.clear();
+		rebuild_router_ = false;
+	}
+
+	void RequestHandler::PublishSnapshot()
+	{
+		RebuildRouter();
+		InitializeMapRenderer();
+		transport_catalogue_->BuildAnswers();
+		transport_catalogue_->BuildNameIndex();
+		transport_catalogue_->BuildStopsIndex();
+		transport_catalogue_->BuildStopNamesIndex();
+
+		versions_.Publish(std::make_shared<const transport_catalogue::snapshot::CatalogueSnapshot>(
+			++version_, transport_catalogue_, transport_router_, map_renderer_));
+
+		catalogue_published_ = true;
+		router_published_ = transport_router_ != nullptr;
 	}
 
 	void RequestHandler::HandleBaseRequests(domain::RequestsMap&& requests)
@@ -124,19 +245,33 @@ namespace request_handler {
 		}
 	}
 	
+	void RequestHandler::PrintCatalogueMemory(std::ostream& out) const
+	{
+		out << "catalogue memory: names_pool="sv << transport_catalogue_->GetNamesPool().GetMemoryUsage()
+			<< " stop_buses_index="sv << transport_catalogue_->GetStopBusesIndexMemory()
+			<< " distances="sv << transport_catalogue_->GetStopDistancesRef().GetMemoryUsage() << '\n';
+	}
+
 	bool RequestHandler::SerializeData(std::ostream& output)
 	{
-		if (!serializer_) {                                              
-			serializer_ = std::make_shared<transport_catalogue::serialize::Serializator>(
-				transport_catalogue_,
-				router_settings_,
-				renderer_settings_);
-		}
+		RebuildRouter();
+		// Набор имён и остановок больше не меняется: индексы по ним строятся здесь, а сериализатор только
+		// читает каталог. У опубликованного каталога индексы уже построены в PublishSnapshot
+		transport_catalogue_->BuildNameIndex();
+		transport_catalogue_->BuildStopsIndex();
+		transport_catalogue_->BuildStopNamesIndex();
+		// после обновлений каталог мог быть заменён копией - сериализатор привязывается к текущему
+		serializer_ = std::make_shared<transport_catalogue::serialize::Serializator>(
+			*transport_catalogue_,
+			router_settings_,
+			renderer_settings_);
 
 		serializer_->GetDataFromCatalogue();                                 
 
 		
 		if (transport_router_) {                                         
+			// в базу пишется граф, а не таблица маршрутов: достаточно построить его
+			transport_router_->EnsureGraph();
 			serializer_->SetRouter(transport_router_);             
 			serializer_->GetDataFromRouter();                                
 		}
@@ -145,9 +280,10 @@ namespace request_handler {
 	}
 	bool RequestHandler::DeserializeData(std::istream& input)
 	{
+		DetachCatalogue();
 		if (!serializer_) {
 			serializer_ = std::make_shared<transport_catalogue::serialize::Serializator>(
-				transport_catalogue_,
+				*transport_catalogue_,
 				router_settings_,
 				renderer_settings_);
 		}
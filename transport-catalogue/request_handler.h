@@ -5,6 +5,7 @@
 #include "transport_catalogue.h"
 #include "transport_router.h"
 #include "serialization.h"
+#include "catalogue_snapshot.h"
 
 using namespace std::literals;
 
@@ -13,18 +14,19 @@ namespace request_handler {
     class RequestHandler {
     public:
 
-        using MapDistanses = std::map<std::string, std::map<std::string, int64_t>>;
+        // Указывают в запросы, живые на время AddStops
+        using MapDistanses = std::map<std::string_view, const domain::Request::Distances*>;
 
         RequestHandler() = default;
 
-        svg::Document RenderMap();
-        const std::string GetMap();
-
         void InitializeMapRenderer();
         void InitializeRouter();
 
         void SetMapRenderSettings(map_renderer::RendererSettings&& settings);
         void SetRouterSettings(transport_catalogue::router::RouterSettings&& settings);
+        void SetCoordinatesQuantization(bool quantized);
+        // Ресурс для маршрутов и графа при сборке базы; должен пережить обработчик
+        void SetMemoryResource(std::pmr::memory_resource* resource);
 
         void InitializeTransportRouterGraph();
 
@@ -33,21 +35,40 @@ namespace request_handler {
 
         void ProcessDistances();
 
-        void AddStops(std::vector<domain::Request>& requests);
-        void AddBuses(std::vector<domain::Request>& requests);
+        void AddStops(domain::RequestsList& requests);
+        void AddBuses(domain::RequestsList& requests);
 
-        domain::StopStat* GetStop(const std::string_view request);
-        domain::BusStat* GetBus(const std::string_view request);
-        domain::RouteStat GetRoute(const std::string_view from, const std::string_view to);
+        // Запросы выполняются над снимком: он не меняется, пока его держит читатель,
+        // даже если писатель тем временем опубликовал следующую версию
+        std::shared_ptr<const transport_catalogue::snapshot::CatalogueSnapshot> GetSnapshot() const;
+        // Делает текущее состояние каталога, маршрутизатора и отрисовщика видимым читателям.
+        // Писатель один; после публикации он меняет уже не эти объекты, а их копии
+        void PublishSnapshot();
 
         void HandleBaseRequests(domain::RequestsMap&& requests);
+        // Изменения загруженной базы: координаты остановок, дорожные расстояния, остановки маршрутов.
+        // Изменение с неизвестной остановкой или маршрутом, позицией вне маршрута или расстоянием
+        // вне диапазона - ошибка: std::invalid_argument или std::out_of_range
+        void HandleUpdateRequests(domain::RequestsList& requests);
         
         bool SerializeData(std::ostream& output);
         bool DeserializeData(std::istream& input);
 
+        // Память пула имён, индекса маршрутов по остановкам и таблицы расстояний - для memory_report
+        void PrintCatalogueMemory(std::ostream& out) const;
+
     private:
 
-        transport_catalogue::TransportCatalogue transport_catalogue_;
+        // Перед изменением каталога: если он попал в живой снимок, дальше правится копия
+        void DetachCatalogue();
+        // Новый маршрутизатор для изменённого каталога, если прежний сброшен
+        void RebuildRouter();
+        // Остановка из запроса на изменение; std::invalid_argument, если её нет
+        domain::Stop* FindUpdatedStop(std::string_view name) const;
+        void MarkChangedBuses(const domain::BusIdsList& bus_ids);
+
+        std::shared_ptr<transport_catalogue::TransportCatalogue> transport_catalogue_ =
+            std::make_shared<transport_catalogue::TransportCatalogue>();
         std::shared_ptr<map_renderer::MapRenderer> map_renderer_ = nullptr;
         std::shared_ptr<transport_catalogue::serialize::Serializator> serializer_ = nullptr;
         std::shared_ptr<transport_catalogue::router::TransportRouter> transport_router_ = nullptr;
@@ -55,6 +76,19 @@ namespace request_handler {
         transport_catalogue::router::RouterSettings router_settings_;
         map_renderer::RendererSettings renderer_settings_;
         MapDistanses map_distances_ = {};
+        std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+
+        transport_catalogue::snapshot::VersionedCatalogue versions_;
+        uint64_t version_ = 0U;
+        // Объекты, попавшие в снимок, писатель больше не меняет
+        bool catalogue_published_ = false;
+        bool router_published_ = false;
+        // Маршрутизатор сброшен вместе с прежним каталогом и создаётся заново при публикации
+        bool rebuild_router_ = false;
+        std::shared_ptr<const transport_catalogue::TransportCatalogue> previous_catalogue_ = nullptr;
+        std::shared_ptr<transport_catalogue::router::TransportRouter> previous_router_ = nullptr;
+        // Маршруты, чьи рёбра в графе нужно построить заново, по id
+        std::vector<bool> changed_buses_;
 
     };
 }
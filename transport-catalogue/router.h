@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graph.h"
+#include "huge_page_allocator.h"
 
 #include <algorithm>
 #include <cassert>
@@ -20,7 +21,8 @@ namespace graph {
         using Graph = DirectedWeightedGraph<Weight>;
 
     public:
-        explicit Router(const Graph& graph);
+        explicit Router(const Graph& graph,
+            memory::HugePagePolicy policy = memory::HugePagePolicy::transparent);
 
         struct RouteInfo {
             Weight weight;
@@ -28,24 +30,39 @@ namespace graph {
         };
 
         std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+        // Кратчайший маршрут до ближайшей из вершин targets: выбор по готовой
+        // таблице за O(targets), восстанавливается только один путь
+        std::optional<RouteInfo> BuildRouteToAny(VertexId from, const std::vector<VertexId>& targets) const;
 
     private:
         struct RouteInternalData {
             Weight weight;
             std::optional<EdgeId> prev_edge;
         };
-        using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+        RouteInfo RestoreRoute(VertexId from, const RouteInternalData& route_internal_data) const;
+
+        // Таблица V x V хранится одним непрерывным массивом построчно,
+        // крупные таблицы размещаются на huge-страницах
+        using RoutesInternalData = std::vector<std::optional<RouteInternalData>,
+            memory::HugePageAllocator<std::optional<RouteInternalData>>>;
+
+        std::optional<RouteInternalData>& Cell(VertexId from, VertexId to) {
+            return routes_internal_data_[from * vertex_count_ + to];
+        }
+        const std::optional<RouteInternalData>& Cell(VertexId from, VertexId to) const {
+            return routes_internal_data_[from * vertex_count_ + to];
+        }
 
         void InitializeRoutesInternalData(const Graph& graph) {
             const size_t vertex_count = graph.GetVertexCount();
             for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-                routes_internal_data_[vertex][vertex] = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
+                Cell(vertex, vertex) = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
                 for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                     const auto& edge = graph.GetEdge(edge_id);
                     if (edge.weight < ZERO_WEIGHT) {
                         throw std::domain_error("Edges' weights should be non-negative");
                     }
-                    auto& route_internal_data = routes_internal_data_[vertex][edge.to];
+                    auto& route_internal_data = Cell(vertex, edge.to);
                     if (!route_internal_data || route_internal_data->weight > edge.weight) {
                         route_internal_data = RouteInternalData{ edge.weight, edge_id };
                     }
@@ -55,7 +72,7 @@ namespace graph {
 
         void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
             const RouteInternalData& route_to) {
-            auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
+            auto& route_relaxing = Cell(vertex_from, vertex_to);
             const Weight candidate_weight = route_from.weight + route_to.weight;
             if (!route_relaxing || candidate_weight < route_relaxing->weight) {
                 route_relaxing = { candidate_weight,
@@ -65,9 +82,9 @@ namespace graph {
 
         void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
             for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-                if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
+                if (const auto& route_from = Cell(vertex_from, vertex_through)) {
                     for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                        if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
+                        if (const auto& route_to = Cell(vertex_through, vertex_to)) {
                             RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
                         }
                     }
@@ -77,14 +94,16 @@ namespace graph {
 
         static constexpr Weight ZERO_WEIGHT{};
         const Graph& graph_;
+        size_t vertex_count_ = 0U;
         RoutesInternalData routes_internal_data_;
     };
 
     template <typename Weight>
-    Router<Weight>::Router(const Graph& graph)
+    Router<Weight>::Router(const Graph& graph, memory::HugePagePolicy policy)
         : graph_(graph)
-        , routes_internal_data_(graph.GetVertexCount(),
-            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+        , vertex_count_(graph.GetVertexCount())
+        , routes_internal_data_(vertex_count_ * vertex_count_,
+            memory::HugePageAllocator<std::optional<RouteInternalData>>(policy))
     {
         InitializeRoutesInternalData(graph);
 
@@ -97,15 +116,46 @@ namespace graph {
     template <typename Weight>
     std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
         VertexId to) const {
-        const auto& route_internal_data = routes_internal_data_.at(from).at(to);
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const auto& route_internal_data = Cell(from, to);
         if (!route_internal_data) {
             return std::nullopt;
         }
-        const Weight weight = route_internal_data->weight;
+        return RestoreRoute(from, *route_internal_data);
+    }
+
+    template <typename Weight>
+    std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRouteToAny(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        if (from >= vertex_count_) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const RouteInternalData* best = nullptr;
+        for (const VertexId to : targets) {
+            if (to >= vertex_count_) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+            const auto& route_internal_data = Cell(from, to);
+            if (route_internal_data && (!best || route_internal_data->weight < best->weight)) {
+                best = &*route_internal_data;
+            }
+        }
+        if (!best) {
+            return std::nullopt;
+        }
+        return RestoreRoute(from, *best);
+    }
+
+    template <typename Weight>
+    typename Router<Weight>::RouteInfo Router<Weight>::RestoreRoute(VertexId from,
+        const RouteInternalData& route_internal_data) const {
+        const Weight weight = route_internal_data.weight;
         std::vector<EdgeId> edges;
-        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
+        for (std::optional<EdgeId> edge_id = route_internal_data.prev_edge;
             edge_id;
-            edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+            edge_id = Cell(from, graph_.GetEdge(*edge_id).from)->prev_edge)
         {
             edges.push_back(*edge_id);
         }
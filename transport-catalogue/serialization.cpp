@@ -4,17 +4,24 @@ namespace transport_catalogue {
 
 	namespace serialize {
 
+		namespace {
+
+			google::protobuf::ArenaOptions MakeArenaOptions() {
+				google::protobuf::ArenaOptions options;
+				options.start_block_size = ARENA_START_BLOCK_SIZE;
+				options.max_block_size = ARENA_MAX_BLOCK_SIZE;
+				return options;
+			}
+
+		}
+
 		Serializator::Serializator(transport_catalogue::TransportCatalogue& transport_catalogue
 			, router::RouterSettings& router_settings, map_renderer::RendererSettings& renderer_settings)
 			: transport_catalogue_(transport_catalogue)
 			, router_settings_(router_settings)
-			, renderer_settings_(renderer_settings) {
-		}
-
-		Serializator& Serializator::SetTransporCatalogue
-		(transport_catalogue::TransportCatalogue& catalogue) {
-			transport_catalogue_ = catalogue;
-			return *this;
+			, renderer_settings_(renderer_settings)
+			, arena_(MakeArenaOptions())
+			, serialization_data_(google::protobuf::Arena::CreateMessage<transport_catalogue_serialize::TransportCatalogue>(&arena_)) {
 		}
 
 		Serializator& Serializator::SetRendererSettings
@@ -36,7 +43,10 @@ namespace transport_catalogue {
 
 		Serializator& Serializator::GetDataFromCatalogue() {
 
+			Serializator::SerializeNamesData();
 			Serializator::SerializeStopsData();
+			Serializator::SerializeStopsIndex();
+			Serializator::SerializeStopNamesIndex();
 			Serializator::SerializeDistancesData();
 			Serializator::SerializeBusesData();
 			Serializator::SerializeRendererSettings();
@@ -56,7 +66,10 @@ namespace transport_catalogue {
 
 		Serializator& Serializator::ApplyDataToCatalogue() {
 
+			Serializator::DeserializeNamesData();
 			Serializator::DeserializeStopsData();
+			Serializator::DeserializeStopsIndex();
+			Serializator::DeserializeStopNamesIndex();
 			Serializator::DeserializeDistancesData();
 			Serializator::DeserializeBusesData();
 			Serializator::DeserializeRendererSettings();
@@ -73,17 +86,15 @@ namespace transport_catalogue {
 
 		bool Serializator::Serialize(std::ostream& output) {
 
-			return serialization_data_.SerializeToOstream(&output);
+			return serialization_data_->SerializeToOstream(&output);
 
 		}
 
 		bool Serializator::Deserialize(std::istream& input) {
 
-			serialization_data_.Clear();                                                  
+			serialization_data_->Clear();                                                  
 
-			serialization_data_.ParseFromIstream(&input);
-
-			return true;
+			return serialization_data_->ParseFromIstream(&input);
 		}
 
 		void Serializator::SerializeColor(const svg::Color& source_color,
@@ -135,49 +146,127 @@ namespace transport_catalogue {
 		bool Serializator::SerializeGraphs(transport_catalogue_serialize::RouterData* serial_router_data) {
 
 			const auto& source_graphs = transport_router_->GetRouterGraphs();
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
 
 			for (size_t i = 0; i != source_graphs.GetEdgeCount(); ++i) {
 				auto serial_edge = serial_router_data->add_router_edges();
 
-				(source_graphs.GetEdge(i).GetEdgeType() == graph::wait) ? serial_edge->set_edge_type("wait") : serial_edge->set_edge_type("move");
+				switch (source_graphs.GetEdge(i).GetEdgeType()) {
+				case graph::wait:
+					serial_edge->set_edge_type("wait");
+					break;
+				case graph::walk:
+					serial_edge->set_edge_type("walk");
+					break;
+				default:
+					serial_edge->set_edge_type("move");
+					break;
+				}
 
 				serial_edge->set_edge_from(source_graphs.GetEdge(i).GetVertexFromId());
 				serial_edge->set_edge_to(source_graphs.GetEdge(i).GetVertexToId());
 
 				serial_edge->set_edge_weight(source_graphs.GetEdge(i).GetEdgeWeight());
-				serial_edge->set_edge_name(std::string(source_graphs.GetEdge(i).GetEdgeName()));
+				serial_edge->set_edge_name_id(*names_pool.Find(source_graphs.GetEdge(i).GetEdgeName()));
 				serial_edge->set_span_count(source_graphs.GetEdge(i).GetEdgeSpanCount());
 
 			}
 			return true;
 		}
+		bool Serializator::SerializeNamesData() {
+
+			serialization_data_->clear_names();
+			serialization_data_->clear_name_index();
+
+			// каждое имя попадает в базу один раз, остальные сообщения ссылаются на него по id
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
+			for (names::NameId id = 0; id != names_pool.size(); ++id) {
+				const std::string_view name = names_pool.Get(id);
+				serialization_data_->add_names(name.data(), name.size());
+			}
+
+			// совершенная хеш-функция построена обработчиком запросов до сериализации
+			const perfect_hash::MinimalPerfectHash& hash = names_pool.GetPerfectHash();
+
+			auto serial_index = serialization_data_->mutable_name_index();
+			serial_index->set_seed(hash.GetSeed());
+			*serial_index->mutable_displacements() = { hash.GetDisplacements().begin(), hash.GetDisplacements().end() };
+			*serial_index->mutable_slots() = { hash.GetSlots().begin(), hash.GetSlots().end() };
+
+			std::string fingerprints;
+			fingerprints.reserve(hash.GetFingerprints().size() * 2);
+			for (const uint16_t fingerprint : hash.GetFingerprints()) {
+				fingerprints.push_back(static_cast<char>(fingerprint & 0xFF));
+				fingerprints.push_back(static_cast<char>(fingerprint >> 8));
+			}
+			serial_index->set_fingerprints(std::move(fingerprints));
+			return true;
+		}
 		bool Serializator::SerializeStopsData() {
 
-			serialization_data_.clear_stops_data();
+			serialization_data_->clear_stops_data();
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
+
+			const bool quantized = transport_catalogue_.IsCoordinatesQuantized();
+			serialization_data_->set_quantized_coordinates(quantized);
+			geo::QuantizedCoordinates prev_coordinates;
 
 			for (auto& source_stop : transport_catalogue_.GetAllStopsData())
 			{
-				auto serial_stop = serialization_data_.add_stops_data();
-				serial_stop->set_stop_name(source_stop->GetStopName());
+				auto serial_stop = serialization_data_->add_stops_data();
+				serial_stop->set_name_id(*names_pool.Find(source_stop->GetStopName()));
+
+				if (quantized) {
+					// соседние по id остановки обычно рядом, разности укладываются в короткие varint
+					const geo::QuantizedCoordinates& coordinates = transport_catalogue_.GetStopQuantizedCoordinates(source_stop->id_);
+					serial_stop->set_latitude_delta(coordinates.lat - prev_coordinates.lat);
+					serial_stop->set_longitude_delta(coordinates.lng - prev_coordinates.lng);
+					prev_coordinates = coordinates;
+				}
+				else {
+					auto serial_stop_coords = serial_stop->mutable_stop_coordinates();
+					serial_stop_coords->set_latitude(source_stop->GetStopCoordinates().GetLatitude());
+					serial_stop_coords->set_longitude(source_stop->GetStopCoordinates().GetLongitude());
+				}
 
-				auto serial_stop_coords = serial_stop->mutable_stop_coordinates();
-				serial_stop_coords->set_latitude(source_stop->GetStopCoordinates().GetLatitude());
-				serial_stop_coords->set_longitude(source_stop->GetStopCoordinates().GetLongitude());
+				for (const BusId bus_id : transport_catalogue_.GetBusIdsForStop(source_stop)) {
+					serial_stop->add_bus_ids(bus_id);
+				}
 			}
 			return true;
 		}
+		bool Serializator::SerializeStopsIndex() {
+
+			// в базу пишется только порядок id: координаты уже есть в stops_data.
+			// Индекс строит RequestHandler до сериализации, здесь он только читается
+			const std::vector<StopId>& order = transport_catalogue_.GetStopsIndex().GetOrder();
+			*serialization_data_->mutable_stops_index() = { order.begin(), order.end() };
+			return true;
+		}
+		bool Serializator::SerializeStopNamesIndex() {
+
+			// порядок id остановок по нормализованному имени; сами имена уже лежат в names
+			const std::vector<StopId>& order = transport_catalogue_.GetStopNamesIndex().GetOrder();
+			*serialization_data_->mutable_stop_names_index() = { order.begin(), order.end() };
+			return true;
+		}
 		bool Serializator::SerializeBusesData() {
 
-			serialization_data_.clear_buses_data();
+			serialization_data_->clear_buses_data();
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
 
 			for (auto source_bus : transport_catalogue_.GetAllBusesData())
 			{
-				auto serial_bus = serialization_data_.add_buses_data();
-				serial_bus->set_bus_name(source_bus->GetBusName());
-
-				auto serial_bus_stops = serial_bus->mutable_bus_stops();
-				for (auto stop : source_bus->GetStops()) {
-					serial_bus_stops->Add(std::move(std::string(stop->GetStopName())));
+				auto serial_bus = serialization_data_->add_buses_data();
+				serial_bus->set_name_id(*names_pool.Find(source_bus->GetBusName()));
+
+				// остановки пишутся один раз разностями соседних id (sint32 - zigzag):
+				// соседние остановки маршрута обычно заведены рядом и разности короткие
+				auto serial_bus_stops = serial_bus->mutable_bus_stop_deltas();
+				int64_t prev_stop_id = 0;
+				for (const StopId stop_id : transport_catalogue_.GetBusStopIds(source_bus->id_).GetStored()) {
+					serial_bus_stops->Add(static_cast<int32_t>(static_cast<int64_t>(stop_id) - prev_stop_id));
+					prev_stop_id = stop_id;
 				}
 
 				serial_bus->set_unique_stops_qty(source_bus->GetUniqueStops());
@@ -194,23 +283,23 @@ namespace transport_catalogue {
 		}
 		bool Serializator::SerializeDistancesData() {
 
-			serialization_data_.clear_distances_data();
+			serialization_data_->clear_distances_data();
 
-			for (auto& source_distance : transport_catalogue_.GetStopDistancesRef())
+			transport_catalogue_.GetStopDistancesRef().ForEach([this](StopId from, StopId to, uint32_t range)
 			{
-				auto serial_distance = serialization_data_.add_distances_data();
+				auto serial_distance = serialization_data_->add_distances_data();
 
-				serial_distance->set_from(source_distance.first.first->name_);
-				serial_distance->set_to(source_distance.first.second->name_);
-				serial_distance->set_range(source_distance.second);
-			}
+				serial_distance->set_from_id(from);
+				serial_distance->set_to_id(to);
+				serial_distance->set_range(range);
+			});
 			return true;
 		}
 		bool Serializator::SerializeRendererSettings() {
 
-			serialization_data_.clear_renderer_settings();
+			serialization_data_->clear_renderer_settings();
 
-			auto serial_renderer_settings = serialization_data_.mutable_renderer_settings();
+			auto serial_renderer_settings = serialization_data_->mutable_renderer_settings();
 
 			serial_renderer_settings->set_width(renderer_settings_.GetWight());
 			serial_renderer_settings->set_height(renderer_settings_.GetHeight());
@@ -237,12 +326,15 @@ namespace transport_catalogue {
 			return true;
 		}
 		bool Serializator::SerializeRouterSettings() {
-			serialization_data_.clear_router_settings();
+			serialization_data_->clear_router_settings();
 
-			auto serial_router_settings = serialization_data_.mutable_router_settings();
+			auto serial_router_settings = serialization_data_->mutable_router_settings();
 
 			serial_router_settings->set_bus_wait_time(router_settings_.GetBusWaitTime());
 			serial_router_settings->set_bus_velocity(router_settings_.GetBusVelocity());
+			serial_router_settings->set_huge_pages(std::string(memory::HugePagePolicyName(router_settings_.GetHugePagePolicy())));
+			serial_router_settings->set_walking_radius(router_settings_.GetWalkingRadius());
+			serial_router_settings->set_walking_velocity(router_settings_.GetWalkingVelocity());
 			return true;
 		}
 		bool Serializator::SerializeRouterData() {
@@ -251,26 +343,14 @@ namespace transport_catalogue {
 			{
 				bool graphs = false;
 
-				serialization_data_.clear_router_data();
-				auto serial_router_data = serialization_data_.mutable_router_data();
+				serialization_data_->clear_router_data();
+				auto serial_router_data = serialization_data_->mutable_router_data();
 
 				serial_router_data->set_vertex_count(transport_router_->GetRouterGraphs().GetVertexCount());
 
 				graphs = SerializeGraphs(serial_router_data);
 
-				for (const auto& item : transport_router_->GetRouterWaitPoints()) {
-					auto wait_point = serial_router_data->add_router_wait_points();
-
-					wait_point->set_wait_point_name(std::string(item.first));
-					wait_point->set_wait_point_id(item.second);
-				}
-
-				for (const auto& item : transport_router_->GetRouterMovePoints()) {
-					auto move_point = serial_router_data->add_router_move_points();
-
-					move_point->set_move_point_name(std::string(item.first));
-					move_point->set_move_point_id(item.second);
-				}
+				// точки ожидания и отправления не сохраняются: вершины однозначно выводятся из id остановок
 
 				if (graphs) return true;
 			}
@@ -302,31 +382,90 @@ namespace transport_catalogue {
 
 			return std::move(result);
 		}
+		bool Serializator::DeserializeNamesData() {
+
+			// имена загружаются в исходном порядке, поэтому их id совпадают с id из базы
+			std::vector<std::string_view> names(serialization_data_->names().begin(), serialization_data_->names().end());
+
+			const auto& serial_index = serialization_data_->name_index();
+			const std::string& serial_fingerprints = serial_index.fingerprints();
+			std::vector<uint16_t> fingerprints(serial_fingerprints.size() / 2);
+			for (size_t i = 0; i != fingerprints.size(); ++i) {
+				fingerprints[i] = static_cast<uint16_t>(static_cast<unsigned char>(serial_fingerprints[2 * i])
+					| static_cast<unsigned char>(serial_fingerprints[2 * i + 1]) << 8);
+			}
+
+			transport_catalogue_.RestoreNames(names, perfect_hash::MinimalPerfectHash(serial_index.seed(),
+				{ serial_index.displacements().begin(), serial_index.displacements().end() },
+				{ serial_index.slots().begin(), serial_index.slots().end() },
+				std::move(fingerprints)));
+			return true;
+		}
 		bool Serializator::DeserializeStopsData() {
 
-			for (const auto& stop : serialization_data_.stops_data()) {
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
+
+			const bool quantized = serialization_data_->quantized_coordinates();
+			transport_catalogue_.SetCoordinatesQuantization(quantized);
+			geo::QuantizedCoordinates coordinates;
+
+			StopId stop_id = 0;
+			for (const auto& stop : serialization_data_->stops_data()) {
 
-				transport_catalogue_.AddStop(std::move(
-					transport_catalogue::Stop()
-					.SetStopName(stop.stop_name())
-					.SetStopCoordinates({
+				transport_catalogue::Stop source_stop;
+				source_stop.SetStopName(names_pool.Get(stop.name_id()));
+				if (quantized) {
+					coordinates.lat += stop.latitude_delta();
+					coordinates.lng += stop.longitude_delta();
+					source_stop.SetStopCoordinates(geo::Dequantize(coordinates));
+				}
+				else {
+					source_stop.SetStopCoordinates({
 						stop.stop_coordinates().latitude(),
-						stop.stop_coordinates().longitude() })
-						));
+						stop.stop_coordinates().longitude() });
+				}
+				transport_catalogue_.AddStop(std::move(source_stop));
+
+				transport_catalogue_.SetBusesForStop(transport_catalogue_.GetStopById(stop_id++),
+					BusIdsList(stop.bus_ids().begin(), stop.bus_ids().end()));
+			}
+			return true;
+		}
+		bool Serializator::DeserializeStopsIndex() {
+
+			// в старых базах индекса нет - строим его по координатам
+			if (serialization_data_->stops_index().empty()
+				|| !transport_catalogue_.RestoreStopsIndex(
+					{ serialization_data_->stops_index().begin(), serialization_data_->stops_index().end() })) {
+				transport_catalogue_.BuildStopsIndex();
+			}
+			return true;
+		}
+		bool Serializator::DeserializeStopNamesIndex() {
+
+			if (serialization_data_->stop_names_index().empty()
+				|| !transport_catalogue_.RestoreStopNamesIndex(
+					{ serialization_data_->stop_names_index().begin(), serialization_data_->stop_names_index().end() })) {
+				transport_catalogue_.BuildStopNamesIndex();
 			}
 			return true;
 		}
 		bool Serializator::DeserializeBusesData() {
-			for (const auto& bus : serialization_data_.buses_data()) {
 
-				std::vector<Stop*> bus_stops;
-				for (const auto& stop : bus.bus_stops()) {
-					bus_stops.push_back(transport_catalogue_.FindStopByName(stop));
+			const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
+			for (const auto& bus : serialization_data_->buses_data()) {
+
+				domain::StopsList bus_stops;
+				bus_stops.reserve(bus.bus_stop_deltas_size());
+				int64_t stop_id = 0;
+				for (const int32_t delta : bus.bus_stop_deltas()) {
+					stop_id += delta;
+					bus_stops.push_back(transport_catalogue_.GetStopById(static_cast<StopId>(stop_id)));
 				}
 
 				transport_catalogue_.AddRouteFromSerializer(std::move(
 					transport_catalogue::Bus()
-					.SetBusName(bus.bus_name())
+					.SetBusName(names_pool.Get(bus.name_id()))
 					.SetStops(std::move(bus_stops))
 					.SetUniqueStops(bus.unique_stops_qty())
 					.SetGeoRouteLength(bus.geo_route_length())
@@ -340,20 +479,20 @@ namespace transport_catalogue {
 		}
 		bool Serializator::DeserializeDistancesData() {
 
-			for (const auto& distance : serialization_data_.distances_data()) {
+			for (const auto& distance : serialization_data_->distances_data()) {
 
 				transport_catalogue_.AddStopsDistance(
-					transport_catalogue_.FindStopByName(distance.from()),
-					transport_catalogue_.FindStopByName(distance.to()), distance.range());
+					transport_catalogue_.GetStopById(distance.from_id()),
+					transport_catalogue_.GetStopById(distance.to_id()), distance.range());
 			}
 
 			return true;
 		}
 		bool Serializator::DeserializeRendererSettings() {
 
-			if (serialization_data_.has_renderer_settings())
+			if (serialization_data_->has_renderer_settings())
 			{
-				auto& serial_renderer_settings = serialization_data_.renderer_settings();
+				auto& serial_renderer_settings = serialization_data_->renderer_settings();
 
 				renderer_settings_.SetWidth(serial_renderer_settings.width());
 				renderer_settings_.SetHeight(serial_renderer_settings.height());
@@ -380,7 +519,7 @@ namespace transport_catalogue {
 					renderer_settings_.AddColorInPalette(std::move(DeseserializeColor(color)));
 				}
 
-				serialization_data_.clear_renderer_settings();
+				serialization_data_->clear_renderer_settings();
 
 				return true;
 			}
@@ -389,14 +528,17 @@ namespace transport_catalogue {
 		}
 		bool Serializator::DeserializeRouterSettings() {
 
-			if (serialization_data_.has_router_settings()) {
+			if (serialization_data_->has_router_settings()) {
 
-				auto& serial_router_settings = serialization_data_.router_settings();
+				auto& serial_router_settings = serialization_data_->router_settings();
 
 				router_settings_.SetBusWaitTime(serial_router_settings.bus_wait_time());
 				router_settings_.SetBusVelocity(serial_router_settings.bus_velocity());
+				router_settings_.SetHugePagePolicy(memory::ParseHugePagePolicy(serial_router_settings.huge_pages()));
+				router_settings_.SetWalkingRadius(serial_router_settings.walking_radius());
+				router_settings_.SetWalkingVelocity(serial_router_settings.walking_velocity());
 
-				serialization_data_.clear_router_settings();
+				serialization_data_->clear_router_settings();
 				return true;
 
 			}
@@ -405,44 +547,38 @@ namespace transport_catalogue {
 		}
 		bool Serializator::DeserializeRouterData() {
 
-			if (serialization_data_.has_router_data()) {
+			if (serialization_data_->has_router_data()) {
 
-				auto& serial_router_data = serialization_data_.router_data();
+				auto& serial_router_data = serialization_data_->router_data();
 
 				graph::DirectedWeightedGraph<double> graphs(serial_router_data.vertex_count());
+				const names::StringPool& names_pool = transport_catalogue_.GetNamesPool();
 
 				auto& edges = serial_router_data.router_edges();
 				for (int i = 0; i != edges.size(); ++i) {
 					graphs.AddEdge(graph::Edge<double>()
 						.SetEdgeType(
-							(edges[i].edge_type() == "wait") ? graph::wait : graph::move)
+							(edges[i].edge_type() == "wait") ? graph::wait
+							: (edges[i].edge_type() == "walk") ? graph::walk : graph::move)
 						.SetVertexFromId(edges[i].edge_from())
 						.SetVertexToId(edges[i].edge_to())
 						.SetEdgeWeight(edges[i].edge_weight())
-						.SetEdgeName(std::string(edges[i].edge_name()))
+						.SetEdgeName(names_pool.Get(edges[i].edge_name_id()))
 						.SetEdgeSpanCount(edges[i].span_count()));
 				}
 
 				std::unordered_map<std::string_view, size_t> wait_points;
-				auto& wait_point = serial_router_data.router_wait_points();
-				for (int i = 0; i != wait_point.size(); ++i) {
-					wait_points[transport_catalogue_
-						.FindStopByName(wait_point[i]
-							.wait_point_name())->name_] = wait_point[i].wait_point_id();
-				}
-
 				std::unordered_map<std::string_view, size_t> move_points;
-				auto& move_point = serial_router_data.router_move_points();
-				for (int i = 0; i != move_point.size(); ++i) {
-					move_points[transport_catalogue_
-						.FindStopByName(move_point[i]
-							.move_point_name())->name_] = move_point[i].move_point_id();
+				const StopId stops_count = static_cast<StopId>(transport_catalogue_.GetStopsCount());
+				for (StopId id = 0; id != stops_count; ++id) {
+					wait_points[transport_catalogue_.GetStopName(id)] = router::TransportRouter::GetWaitVertex(id);
+					move_points[transport_catalogue_.GetStopName(id)] = router::TransportRouter::GetMoveVertex(id);
 				}
 
 				transport_router_->SetRouterGraphs(std::move(graphs));
 				transport_router_->SetRouterWaitPoints(std::move(wait_points));
 				transport_router_->SetRouterMovePoints(std::move(move_points));
-				serialization_data_.clear_router_data();
+				serialization_data_->clear_router_data();
 				return true;
 
 			}
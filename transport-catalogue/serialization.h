@@ -4,6 +4,7 @@
 #include "transport_catalogue.h"
 
 #include <transport_catalogue.pb.h>
+#include <google/protobuf/arena.h>
 
 #include <iostream>
 #include <fstream>
@@ -13,6 +14,10 @@ namespace transport_catalogue {
 
 	namespace serialize {
 
+		// Блоки арены protobuf растут от начального до максимального размера
+		constexpr size_t ARENA_START_BLOCK_SIZE = 64U * 1024U;
+		constexpr size_t ARENA_MAX_BLOCK_SIZE = 4U * 1024U * 1024U;
+
 		class Serializator {
 		private:
 			transport_catalogue::TransportCatalogue& transport_catalogue_;                             
@@ -26,7 +31,6 @@ namespace transport_catalogue {
 			Serializator(transport_catalogue::TransportCatalogue&
 				, router::RouterSettings&, map_renderer::RendererSettings&);                             
 
-			Serializator& SetTransporCatalogue(transport_catalogue::TransportCatalogue&);            
 			Serializator& SetRendererSettings(map_renderer::RendererSettings&);                      
 			Serializator& SetRouterSettings(router::RouterSettings&);                                
 			Serializator& SetRouter(std::shared_ptr<router::TransportRouter>);              
@@ -41,13 +45,19 @@ namespace transport_catalogue {
 
 		private:
                                             
-			transport_catalogue_serialize::TransportCatalogue serialization_data_;                             
+			// Сообщения базы - сотни тысяч мелких объектов (по одному на ребро графа),
+			// поэтому они размещаются в арене protobuf и освобождаются вместе с ней
+			google::protobuf::Arena arena_;
+			transport_catalogue_serialize::TransportCatalogue* serialization_data_;
 
 			void SerializeColor(
 				const svg::Color&, transport_catalogue_serialize::Color*);                             
 			bool SerializeGraphs(transport_catalogue_serialize::RouterData*);                      
 
+			bool SerializeNamesData();
 			bool SerializeStopsData();                                                            
+			bool SerializeStopsIndex();
+			bool SerializeStopNamesIndex();
 			bool SerializeBusesData();                                                            
 			bool SerializeDistancesData();                                                        
 			bool SerializeRendererSettings();                                                      
@@ -56,7 +66,10 @@ namespace transport_catalogue {
 
 			svg::Color DeseserializeColor(
 				const transport_catalogue_serialize::Color&);
+			bool DeserializeNamesData();
 			bool DeserializeStopsData();                                                         
+			bool DeserializeStopsIndex();
+			bool DeserializeStopNamesIndex();
 			bool DeserializeBusesData();                                                         
 			bool DeserializeDistancesData();                                                     
 			bool DeserializeRendererSettings();                                                   
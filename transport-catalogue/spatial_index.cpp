@@ -0,0 +1,316 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace spatial {
+
+    namespace {
+
+        template <typename Point>
+        double AxisValue(const Point& point, size_t depth) {
+            return depth % 2 == 0 ? point.lat : point.lng;
+        }
+
+        bool NeighborLess(const Neighbor& lhs, const Neighbor& rhs) {
+            return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.id < rhs.id);
+        }
+
+        bool IsWide(const std::vector<geo::Coordinates>& points) {
+            if (points.empty()) {
+                return false;
+            }
+            const auto [min, max] = std::minmax_element(points.begin(), points.end(),
+                [](const geo::Coordinates& lhs, const geo::Coordinates& rhs) {
+                    return lhs.lng < rhs.lng;
+                });
+            return max->lng - min->lng >= 180.0;
+        }
+
+        // acos в geo::ComputeDistance у почти совпадающих точек может вернуть NaN
+        double Distance(const geo::TrigonometricTable& points, const geo::TrigonometricTable::Point& from, size_t to) {
+            const double distance = points.ComputeDistance(from, to);
+            return std::isnan(distance) ? 0.0 : distance;
+        }
+
+        struct Entry {
+            uint32_t id;
+            geo::Coordinates point;
+        };
+
+        using EntryIt = std::vector<Entry>::iterator;
+
+        void BuildRange(EntryIt first, EntryIt last, size_t depth) {
+            if (last - first < 2) {
+                return;
+            }
+            const EntryIt mid = first + (last - first) / 2;
+            std::nth_element(first, mid, last, [depth](const Entry& lhs, const Entry& rhs) {
+                return AxisValue(lhs.point, depth) < AxisValue(rhs.point, depth);
+            });
+            BuildRange(first, mid, depth + 1);
+            BuildRange(mid + 1, last, depth + 1);
+        }
+
+    }  // namespace
+
+    std::vector<NearbyPair> FindPairsWithin(const std::vector<geo::Coordinates>& points, double radius) {
+        std::vector<NearbyPair> result;
+        if (radius <= 0.0 || points.size() < 2) {
+            return result;
+        }
+
+        double min_lat = points.front().lat;
+        double min_lng = points.front().lng;
+        double max_lng = points.front().lng;
+        double max_abs_lat = 0.0;
+        for (const geo::Coordinates& point : points) {
+            min_lat = std::min(min_lat, point.lat);
+            min_lng = std::min(min_lng, point.lng);
+            max_lng = std::max(max_lng, point.lng);
+            max_abs_lat = std::max(max_abs_lat, std::abs(point.lat));
+        }
+
+        // Шаг по широте - угол radius; по долготе - наибольшая разность долгот точек на расстоянии
+        // radius на самой далёкой от экватора широте. У полюсов столбец один на всю долготу
+        const double angle = radius / EarthRadius;
+        const double lat_step = angle / RadToDegCoef;
+        const double lng_sin = std::sin(angle) / std::cos(max_abs_lat * RadToDegCoef);
+        const double lng_step = lng_sin >= 1.0 ? 360.0 : std::asin(lng_sin) / RadToDegCoef;
+        const uint64_t columns = static_cast<uint64_t>((max_lng - min_lng) / lng_step) + 1;
+
+        const auto cell_row = [&](const geo::Coordinates& point) {
+            return static_cast<uint64_t>((point.lat - min_lat) / lat_step);
+        };
+        const auto cell_column = [&](const geo::Coordinates& point) {
+            return static_cast<uint64_t>((point.lng - min_lng) / lng_step);
+        };
+
+        // Приближённое расстояние отсеивает дальних кандидатов до точного расчёта, пока его
+        // погрешность известна; больший радиус или точки у полюса проверяются только точно
+        geo::TrigonometricTable table;
+        table.Assign(points);
+        using Table = geo::TrigonometricTable;
+        const bool filter = radius <= Table::APPROXIMATE_MAX_DISTANCE && max_abs_lat <= Table::APPROXIMATE_MAX_LATITUDE;
+        const double filter_radius = radius * (1.0 + Table::APPROXIMATE_RELATIVE_ERROR) + Table::APPROXIMATE_ABSOLUTE_ERROR;
+
+        // Ячейки - отрезки массива точек, отсортированного по номеру ячейки
+        std::vector<std::pair<uint64_t, uint32_t>> cells;
+        cells.reserve(points.size());
+        for (uint32_t id = 0; id != points.size(); ++id) {
+            cells.push_back({ cell_row(points[id]) * columns + cell_column(points[id]), id });
+        }
+        std::sort(cells.begin(), cells.end());
+
+        std::vector<uint32_t> candidates;
+        std::vector<double> estimates;
+        for (uint32_t id = 0; id != points.size(); ++id) {
+            const uint64_t row = cell_row(points[id]);
+            const uint64_t column = cell_column(points[id]);
+            candidates.clear();
+            for (uint64_t near_row = row == 0 ? 0 : row - 1; near_row <= row + 1; ++near_row) {
+                // Соседние по строке ячейки идут в массиве подряд - один отрезок на три ячейки
+                const uint64_t first_cell = near_row * columns + (column == 0 ? 0 : column - 1);
+                const uint64_t last_cell = near_row * columns + std::min(column + 1, columns - 1);
+                auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(first_cell, 0U));
+                for (; it != cells.end() && it->first <= last_cell; ++it) {
+                    if (it->second > id) {
+                        candidates.push_back(it->second);
+                    }
+                }
+            }
+
+            if (filter) {
+                estimates.resize(candidates.size());
+                table.ComputeApproximateDistances(id, candidates.data(), candidates.size(), estimates.data());
+            }
+            const Table::Point from = table.GetPoint(id);
+            for (size_t i = 0; i != candidates.size(); ++i) {
+                if (filter && estimates[i] > filter_radius) {
+                    continue;
+                }
+                const double distance = Distance(table, from, candidates[i]);
+                if (distance <= radius) {
+                    result.push_back({ id, candidates[i], distance });
+                }
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [](const NearbyPair& lhs, const NearbyPair& rhs) {
+            return lhs.from < rhs.from || (lhs.from == rhs.from && lhs.to < rhs.to);
+        });
+        return result;
+    }
+
+    void SpatialIndex::Build(const std::vector<geo::Coordinates>& points) {
+        std::vector<Entry> entries;
+        entries.reserve(points.size());
+        for (uint32_t id = 0; id != points.size(); ++id) {
+            entries.push_back({ id, points[id] });
+        }
+        BuildRange(entries.begin(), entries.end(), 0U);
+
+        order_.clear();
+        points_.Clear();
+        order_.reserve(entries.size());
+        for (const Entry& entry : entries) {
+            order_.push_back(entry.id);
+            points_.PushBack(entry.point);
+        }
+        wide_ = IsWide(points);
+    }
+
+    bool SpatialIndex::Restore(std::vector<uint32_t>&& order, const std::vector<geo::Coordinates>& points) {
+        order_.clear();
+        points_.Clear();
+        if (order.size() != points.size()) {
+            return false;
+        }
+
+        std::vector<bool> seen(points.size(), false);
+        for (const uint32_t id : order) {
+            if (id >= points.size() || seen[id]) {
+                return false;
+            }
+            seen[id] = true;
+        }
+
+        order_ = std::move(order);
+        for (const uint32_t id : order_) {
+            points_.PushBack(points[id]);
+        }
+        wide_ = IsWide(points);
+        return true;
+    }
+
+    double SpatialIndex::DistanceToSplit(const Point& point, const geo::Coordinates& split, size_t depth) const {
+        if (depth % 2 == 0) {
+            // Дуга большого круга не короче разности широт её концов
+            return std::abs(point.lat - split.lat) * RadToDegCoef * EarthRadius;
+        }
+
+        // Расстояние до большого круга меридиана разделяющей точки
+        const double delta = std::abs(point.lng - split.lng);
+        if (wide_ || delta >= 90.0) {
+            return 0.0;
+        }
+        return std::asin(point.lat_cos * std::sin(delta * RadToDegCoef)) * EarthRadius;
+    }
+
+    template <typename Visitor, typename Limit>
+    void SpatialIndex::Search(size_t lo, size_t hi, size_t depth, const Point& point,
+        Visitor& visit, const Limit& limit) const {
+        if (lo >= hi) {
+            return;
+        }
+
+        const size_t mid = lo + (hi - lo) / 2;
+        const geo::Coordinates split = points_.Get(mid);
+        visit(order_[mid], Distance(points_, point, mid));
+
+        // Сначала поддерево со стороны точки: граница поиска сужается раньше
+        const bool left_first = AxisValue(point, depth) < AxisValue(split, depth);
+        if (left_first) {
+            Search(lo, mid, depth + 1, point, visit, limit);
+        }
+        else {
+            Search(mid + 1, hi, depth + 1, point, visit, limit);
+        }
+
+        if (DistanceToSplit(point, split, depth) <= limit() + DISTANCE_SLACK) {
+            if (left_first) {
+                Search(mid + 1, hi, depth + 1, point, visit, limit);
+            }
+            else {
+                Search(lo, mid, depth + 1, point, visit, limit);
+            }
+        }
+    }
+
+    std::vector<Neighbor> SpatialIndex::Nearest(geo::Coordinates point, size_t count) const {
+        std::vector<Neighbor> heap;
+        count = std::min(count, order_.size());
+        if (count == 0) {
+            return heap;
+        }
+        heap.reserve(count);
+
+        // Куча по убыванию: в вершине - самая дальняя из найденных
+        auto visit = [&heap, count](uint32_t id, double distance) {
+            const Neighbor candidate{ id, distance };
+            if (heap.size() < count) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), NeighborLess);
+            }
+            else if (NeighborLess(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), NeighborLess);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), NeighborLess);
+            }
+        };
+        auto limit = [&heap, count]() {
+            return heap.size() < count ? std::numeric_limits<double>::infinity() : heap.front().distance;
+        };
+        Search(0U, order_.size(), 0U, geo::TrigonometricTable::MakePoint(point), visit, limit);
+
+        std::sort_heap(heap.begin(), heap.end(), NeighborLess);
+        return heap;
+    }
+
+    std::vector<Neighbor> SpatialIndex::InRadius(geo::Coordinates point, double radius) const {
+        std::vector<Neighbor> result;
+        if (radius < 0.0) {
+            return result;
+        }
+
+        auto visit = [&result, radius](uint32_t id, double distance) {
+            if (distance <= radius) {
+                result.push_back({ id, distance });
+            }
+        };
+        auto limit = [radius]() {
+            return radius;
+        };
+        Search(0U, order_.size(), 0U, geo::TrigonometricTable::MakePoint(point), visit, limit);
+
+        std::sort(result.begin(), result.end(), NeighborLess);
+        return result;
+    }
+
+    void SpatialIndex::SearchBox(size_t lo, size_t hi, size_t depth, const geo::Coordinates& min,
+        const geo::Coordinates& max, const Point& center, std::vector<Neighbor>& result) const {
+        if (lo >= hi) {
+            return;
+        }
+
+        const size_t mid = lo + (hi - lo) / 2;
+        const geo::Coordinates split = points_.Get(mid);
+        if (split.lat >= min.lat && split.lat <= max.lat && split.lng >= min.lng && split.lng <= max.lng) {
+            result.push_back({ order_[mid], Distance(points_, center, mid) });
+        }
+
+        const double value = AxisValue(split, depth);
+        if (AxisValue(min, depth) <= value) {
+            SearchBox(lo, mid, depth + 1, min, max, center, result);
+        }
+        if (AxisValue(max, depth) >= value) {
+            SearchBox(mid + 1, hi, depth + 1, min, max, center, result);
+        }
+    }
+
+    std::vector<Neighbor> SpatialIndex::InBox(geo::Coordinates min, geo::Coordinates max) const {
+        std::vector<Neighbor> result;
+        if (min.lat > max.lat || min.lng > max.lng) {
+            return result;
+        }
+
+        const geo::Coordinates center{ (min.lat + max.lat) / 2, (min.lng + max.lng) / 2 };
+        SearchBox(0U, order_.size(), 0U, min, max, geo::TrigonometricTable::MakePoint(center), result);
+
+        std::sort(result.begin(), result.end(), NeighborLess);
+        return result;
+    }
+
+}  // namespace spatial
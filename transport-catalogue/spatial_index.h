@@ -0,0 +1,84 @@
+#pragma once
+
+#include "geo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace spatial {
+
+    struct Neighbor {
+        uint32_t id = 0U;
+        double distance = 0.0;   // в метрах, как geo::ComputeDistance
+    };
+
+    struct NearbyPair {
+        uint32_t from = 0U;      // from < to
+        uint32_t to = 0U;
+        double distance = 0.0;
+    };
+
+    // Все пары точек не дальше radius метров друг от друга, упорядоченные по (from, to).
+    // Точки раскладываются по равномерной сетке с ячейкой не меньше radius по обеим осям,
+    // и каждая сравнивается только с точками своей и восьми соседних ячеек.
+    // Пары через антимеридиан не ищутся
+    std::vector<NearbyPair> FindPairsWithin(const std::vector<geo::Coordinates>& points, double radius);
+
+    // Статическое k-d дерево над координатами остановок без явных узлов.
+    // Точки переставлены так, что поддерево - отрезок [lo, hi) массива: в середине лежит
+    // разделяющая точка, слева - не большие её по оси, справа - не меньшие.
+    // Ось чередуется с глубиной (широта, долгота, ...), поэтому для восстановления дерева
+    // достаточно порядка id, а координаты берутся из каталога без сортировки
+    class SpatialIndex {
+    public:
+        SpatialIndex() = default;
+
+        // points индексируются id остановки
+        void Build(const std::vector<geo::Coordinates>& points);
+        // Порядок id из базы; false - порядок не является перестановкой id точек, индекс пуст
+        bool Restore(std::vector<uint32_t>&& order, const std::vector<geo::Coordinates>& points);
+
+        // Ответы упорядочены по расстоянию, при равенстве - по id
+        std::vector<Neighbor> Nearest(geo::Coordinates point, size_t count) const;
+        std::vector<Neighbor> InRadius(geo::Coordinates point, double radius) const;
+        // Точки прямоугольника широт и долгот; расстояние считается от его центра
+        std::vector<Neighbor> InBox(geo::Coordinates min, geo::Coordinates max) const;
+
+        const std::vector<uint32_t>& GetOrder() const {
+            return order_;
+        }
+
+        size_t size() const {
+            return order_.size();
+        }
+
+        bool empty() const {
+            return order_.empty();
+        }
+
+    private:
+        // Погрешность acos в geo::ComputeDistance на малых углах - доли метра:
+        // поддерево отбрасывается, только если оно дальше границы с этим запасом
+        static constexpr double DISTANCE_SLACK = 1.0;
+
+        using Point = geo::TrigonometricTable::Point;
+
+        // Нижняя оценка расстояния от точки до полупространства за разделяющей плоскостью узла
+        double DistanceToSplit(const Point& point, const geo::Coordinates& split, size_t depth) const;
+
+        template <typename Visitor, typename Limit>
+        void Search(size_t lo, size_t hi, size_t depth, const Point& point,
+            Visitor& visit, const Limit& limit) const;
+        void SearchBox(size_t lo, size_t hi, size_t depth, const geo::Coordinates& min,
+            const geo::Coordinates& max, const Point& center, std::vector<Neighbor>& result) const;
+
+        std::vector<uint32_t> order_;
+        // Координаты в порядке order_: обход дерева читает их подряд, тригонометрия
+        // широты узлов посчитана при построении
+        geo::TrigonometricTable points_;
+        // Оценка по долготе верна, пока точки занимают меньше полусферы по долготе
+        bool wide_ = false;
+    };
+
+}  // namespace spatial
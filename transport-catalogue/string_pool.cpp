@@ -0,0 +1,108 @@
+#include "string_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace names {
+
+    NameId StringPool::Intern(std::string_view name) {
+        if (auto id = Find(name)) {
+            return *id;
+        }
+
+        // Набор имён меняется - функция больше не совершенная, переходим на обычный индекс
+        if (!perfect_hash_.empty()) {
+            perfect_hash_ = {};
+            if (index_.size() != names_.size()) {
+                BuildIndex();
+            }
+        }
+
+        const NameId id = static_cast<NameId>(names_.size());
+        const std::string_view stored = Store(name);
+        names_.push_back(stored);
+        index_.emplace(stored, id);
+
+        return id;
+    }
+
+    std::optional<NameId> StringPool::Find(std::string_view name) const {
+        if (!perfect_hash_.empty()) {
+            // отпечаток отсекает почти все чужие имена, сравнение строк нужно лишь для совпавших
+            if (auto id = perfect_hash_.Lookup(name); id && names_[*id] == name) {
+                return id;
+            }
+            return std::nullopt;
+        }
+        if (auto it = index_.find(name); it != index_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    void StringPool::BuildPerfectHash() {
+        // Функция над этим же набором имён уже есть: новое имя сбросило бы её
+        if (!perfect_hash_.empty() && perfect_hash_.size() == names_.size()) {
+            return;
+        }
+        perfect_hash_.Build(names_);
+    }
+
+    void StringPool::Restore(const std::vector<std::string_view>& names, perfect_hash::MinimalPerfectHash&& hash) {
+        blocks_.clear();
+        blocks_bytes_ = 0U;
+        block_pos_ = nullptr;
+        block_left_ = 0U;
+        names_.clear();
+        index_.clear();
+
+        names_.reserve(names.size());
+        for (const std::string_view name : names) {
+            names_.push_back(Store(name));
+        }
+
+        perfect_hash_ = std::move(hash);
+        // База без функции или с функцией от другого набора имён - строим обычный индекс
+        if (perfect_hash_.size() != names_.size()) {
+            perfect_hash_ = {};
+            BuildIndex();
+        }
+    }
+
+    void StringPool::BuildIndex() {
+        index_.clear();
+        index_.reserve(names_.size());
+        for (NameId id = 0; id != names_.size(); ++id) {
+            index_.emplace(names_[id], id);
+        }
+    }
+
+    size_t StringPool::GetMemoryUsage() const {
+        return blocks_bytes_
+            + perfect_hash_.GetMemoryUsage()
+            + names_.capacity() * sizeof(std::string_view)
+            + index_.bucket_count() * sizeof(void*)
+            + index_.size() * (sizeof(std::pair<const std::string_view, NameId>) + sizeof(void*));
+    }
+
+    std::string_view StringPool::Store(std::string_view name) {
+        if (name.size() > block_left_) {
+            // Имя длиннее блока получает отдельный блок под себя
+            const size_t block_size = std::max(BLOCK_SIZE, name.size());
+            blocks_.push_back(std::make_unique<char[]>(block_size));
+            blocks_bytes_ += block_size;
+            block_pos_ = blocks_.back().get();
+            block_left_ = block_size;
+        }
+
+        char* data = block_pos_;
+        if (!name.empty()) {
+            std::memcpy(data, name.data(), name.size());
+        }
+        block_pos_ += name.size();
+        block_left_ -= name.size();
+
+        return { data, name.size() };
+    }
+
+}  // namespace names
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "perfect_hash.h"
+
+namespace names {
+
+    using NameId = uint32_t;
+
+    // Пул интернированных строк: каждое имя хранится один раз в арене из крупных блоков
+    // и далее передаётся по id или string_view. Блоки не перемещаются,
+    // поэтому выданные string_view живут столько же, сколько пул
+    class StringPool {
+    public:
+        StringPool() = default;
+
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        // Возвращает id имени, добавляя его в пул при первом обращении
+        NameId Intern(std::string_view name);
+
+        // Поиск без добавления. Ключи индекса - string_view, поэтому поиск
+        // по std::string или string_view из запроса не создаёт временных строк.
+        // Если построена совершенная хеш-функция, поиск идёт через неё
+        std::optional<NameId> Find(std::string_view name) const;
+
+        // Строит совершенную хеш-функцию над текущим набором имён, если её ещё нет.
+        // Добавление нового имени после этого сбрасывает её
+        void BuildPerfectHash();
+        const perfect_hash::MinimalPerfectHash& GetPerfectHash() const {
+            return perfect_hash_;
+        }
+
+        // Загружает сохранённые имена вместе с построенной по ним функцией:
+        // хеш-таблица индекса при этом не строится
+        void Restore(const std::vector<std::string_view>& names, perfect_hash::MinimalPerfectHash&& hash);
+
+        std::string_view Get(NameId id) const {
+            return names_[id];
+        }
+
+        size_t size() const {
+            return names_.size();
+        }
+
+        // Байт, занятых блоками арены, таблицей имён и индексом
+        size_t GetMemoryUsage() const;
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 64U * 1024U;
+
+        std::string_view Store(std::string_view name);
+        void BuildIndex();
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        size_t blocks_bytes_ = 0U;
+        char* block_pos_ = nullptr;
+        size_t block_left_ = 0U;
+
+        std::vector<std::string_view> names_;
+        std::unordered_map<std::string_view, NameId> index_;
+        perfect_hash::MinimalPerfectHash perfect_hash_;
+    };
+
+}  // namespace names
@@ -0,0 +1,309 @@
+// Проверки transport_catalogue::TransportCatalogue: пакетное добавление маршрутов с параллельным
+// расчётом статистики даёт те же ответы, что и добавление по одному, а некольцевой маршрут,
+// хранимый один раз, проходится туда и обратно; поиск по сброшенным пространственному индексу
+// и индексу имён не отвечает устаревшими данными
+
+#include "../transport_catalogue.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, std::string_view name) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " for "sv << name << '\n';
+            }
+        }
+    }
+
+    struct RouteDescription {
+        std::string name;
+        std::vector<size_t> stops;
+        bool is_circular = false;
+    };
+
+    struct City {
+        std::vector<std::string> stop_names;
+        std::vector<geo::Coordinates> coordinates;
+        // Расстояния заданы в одну сторону: обратное берётся из них же
+        std::vector<std::tuple<size_t, size_t, size_t>> distances;
+        std::vector<RouteDescription> routes;
+    };
+
+    City MakeCity(size_t stop_count, size_t route_count) {
+        std::mt19937 generator(34);
+        std::uniform_real_distribution<double> latitude(55.5, 55.9);
+        std::uniform_real_distribution<double> longitude(37.3, 37.9);
+        std::uniform_int_distribution<size_t> stop(0U, stop_count - 1);
+        std::uniform_int_distribution<size_t> distance(100U, 5000U);
+        std::uniform_int_distribution<size_t> length(2U, 30U);
+
+        City city;
+        for (size_t i = 0; i != stop_count; ++i) {
+            city.stop_names.push_back("Stop "s + std::to_string(i));
+            city.coordinates.push_back({ latitude(generator), longitude(generator) });
+        }
+        for (size_t i = 0; i != route_count; ++i) {
+            RouteDescription route;
+            route.name = std::to_string(i);
+            route.is_circular = generator() % 2 == 0;
+            const size_t stops = length(generator);
+            for (size_t j = 0; j != stops; ++j) {
+                route.stops.push_back(stop(generator));
+            }
+            if (route.is_circular) {
+                route.stops.push_back(route.stops.front());
+            }
+            for (size_t j = 1; j < route.stops.size(); ++j) {
+                if (generator() % 3 != 0) {
+                    city.distances.emplace_back(route.stops[j - 1], route.stops[j], distance(generator));
+                }
+            }
+            city.routes.push_back(std::move(route));
+        }
+        return city;
+    }
+
+    void AddStops(transport_catalogue::TransportCatalogue& catalogue, const City& city) {
+        for (size_t i = 0; i != city.stop_names.size(); ++i) {
+            catalogue.AddStop({ city.stop_names[i], city.coordinates[i].lat, city.coordinates[i].lng });
+        }
+        for (const auto& [from, to, distance] : city.distances) {
+            catalogue.AddStopsDistance(catalogue.FindStopByName(city.stop_names[from]),
+                catalogue.FindStopByName(city.stop_names[to]), distance);
+        }
+    }
+
+    domain::Bus MakeBus(const transport_catalogue::TransportCatalogue& catalogue, const City& city, const RouteDescription& route) {
+        domain::Bus bus;
+        bus.bus_name_ = route.name;
+        bus.is_circular_ = route.is_circular;
+        for (const size_t stop : route.stops) {
+            bus.stops_.push_back(catalogue.FindStopByName(city.stop_names[stop]));
+        }
+        return bus;
+    }
+
+    void TestParallelAddBuses() {
+        // Достаточно маршрутов на четыре задачи
+        const City city = MakeCity(300U, 4U * transport_catalogue::TransportCatalogue::MIN_BUSES_PER_TASK + 3U);
+
+        transport_catalogue::TransportCatalogue sequential;
+        AddStops(sequential, city);
+        for (const RouteDescription& route : city.routes) {
+            sequential.AddBus(MakeBus(sequential, city, route));
+        }
+        sequential.BuildAnswers();
+
+        transport_catalogue::TransportCatalogue parallel;
+        AddStops(parallel, city);
+        std::vector<domain::Bus> buses;
+        for (const RouteDescription& route : city.routes) {
+            buses.push_back(MakeBus(parallel, city, route));
+        }
+        parallel.AddBuses(std::move(buses), 4U);
+        parallel.BuildAnswers();
+
+        for (const RouteDescription& route : city.routes) {
+            const domain::BusStat* expected = sequential.GetBusInfo(route.name);
+            const domain::BusStat* actual = parallel.GetBusInfo(route.name);
+            Check(expected != nullptr && actual != nullptr, "bus is found"sv, route.name);
+            if (expected == nullptr || actual == nullptr) {
+                continue;
+            }
+            Check(actual->bus_stops_num_ == expected->bus_stops_num_, "stops on route"sv, route.name);
+            Check(actual->unique_stops_num_ == expected->unique_stops_num_, "unique stops"sv, route.name);
+            Check(actual->route_length_ == expected->route_length_, "route length"sv, route.name);
+            Check(actual->route_curvature_ == expected->route_curvature_, "curvature"sv, route.name);
+        }
+        for (const std::string& name : city.stop_names) {
+            const domain::StopStat* expected = sequential.GetBusesForStopInfo(name);
+            const domain::StopStat* actual = parallel.GetBusesForStopInfo(name);
+            Check(expected != nullptr && actual != nullptr
+                && std::vector<std::string_view>(actual->buses_.begin(), actual->buses_.end())
+                    == std::vector<std::string_view>(expected->buses_.begin(), expected->buses_.end()),
+                "buses through stop"sv, name);
+        }
+    }
+
+    template <typename Range>
+    std::vector<int> Forward(const Range& range) {
+        return std::vector<int>(range.begin(), range.end());
+    }
+
+    template <typename Range>
+    std::vector<int> Backward(const Range& range) {
+        std::vector<int> result;
+        for (auto it = range.end(); it != range.begin();) {
+            result.push_back(*--it);
+        }
+        return result;
+    }
+
+    void TestRouteRange() {
+        using RouteRange = ranges::RouteRange<std::vector<int>::const_iterator>;
+        const std::vector<int> stops{ 1, 2, 3, 4 };
+
+        const RouteRange there_and_back(stops.begin(), stops.end(), false);
+        const std::vector<int> expected{ 1, 2, 3, 4, 3, 2, 1 };
+        Check(there_and_back.size() == expected.size(), "return leg size"sv, "1-2-3-4"sv);
+        Check(Forward(there_and_back) == expected, "return leg by iterator"sv, "1-2-3-4"sv);
+        Check(Backward(there_and_back) == std::vector<int>(expected.rbegin(), expected.rend()),
+            "return leg backwards"sv, "1-2-3-4"sv);
+        bool indexed = true;
+        for (size_t i = 0; i != expected.size(); ++i) {
+            indexed = indexed && there_and_back[i] == expected[i];
+        }
+        Check(indexed, "return leg by index"sv, "1-2-3-4"sv);
+        Check(Forward(there_and_back.GetStored()) == stops, "stored stops"sv, "1-2-3-4"sv);
+
+        const RouteRange circle(stops.begin(), stops.end(), true);
+        Check(Forward(circle) == stops && circle.size() == stops.size(), "no return leg on a circle"sv, "1-2-3-4"sv);
+
+        const std::vector<int> single{ 5 };
+        const RouteRange one_stop(single.begin(), single.end(), false);
+        Check(Forward(one_stop) == single, "single stop"sv, "5"sv);
+        const std::vector<int> none;
+        const RouteRange empty(none.begin(), none.end(), false);
+        Check(empty.empty() && empty.size() == 0U && Forward(empty).empty(), "empty route"sv, ""sv);
+    }
+
+    // Маршрут A - B - C: обратные расстояния заданы не для всех перегонов
+    void TestReturnLegInCatalogue() {
+        transport_catalogue::TransportCatalogue catalogue;
+        catalogue.AddStop({ "A"sv, 55.60, 37.60 });
+        catalogue.AddStop({ "B"sv, 55.61, 37.60 });
+        catalogue.AddStop({ "C"sv, 55.62, 37.60 });
+        domain::Stop* a = catalogue.FindStopByName("A"sv);
+        domain::Stop* b = catalogue.FindStopByName("B"sv);
+        domain::Stop* c = catalogue.FindStopByName("C"sv);
+        catalogue.AddStopsDistance(a, b, 1000U);
+        catalogue.AddStopsDistance(b, c, 2000U);
+        catalogue.AddStopsDistance(c, b, 2500U);
+
+        domain::Bus bus;
+        bus.bus_name_ = "line"sv;
+        bus.is_circular_ = false;
+        bus.stops_ = { a, b, c };
+        catalogue.AddBus(std::move(bus));
+        catalogue.BuildAnswers();
+
+        const domain::Bus* stored = catalogue.FindRouteByName("line"sv);
+        Check(stored != nullptr && stored->stops_.size() == 3U, "return leg is not stored"sv, "line"sv);
+        if (stored != nullptr) {
+            std::vector<domain::StopId> ids;
+            for (const domain::StopId id : catalogue.GetBusStopIds(stored->id_)) {
+                ids.push_back(id);
+            }
+            Check(ids == std::vector<domain::StopId>{ a->id_, b->id_, c->id_, b->id_, a->id_ }, "stop ids there and back"sv, "line"sv);
+        }
+
+        const domain::BusStat* stat = catalogue.GetBusInfo("line"sv);
+        Check(stat != nullptr && stat->bus_stops_num_ == 5U && stat->unique_stops_num_ == 3U, "stop counts"sv, "line"sv);
+        // Обратно: C -> B задано, B -> A берётся из A -> B
+        Check(stat != nullptr && stat->route_length_ == 1000U + 2000U + 2500U + 1000U, "length there and back"sv, "line"sv);
+    }
+
+    // Перемещённая остановка сбрасывает индекс: поиск бросает исключение до его перестроения
+    void TestStaleStopsIndex() {
+        transport_catalogue::TransportCatalogue catalogue;
+        catalogue.AddStop({ "A"sv, 55.60, 37.60 });
+        catalogue.AddStop({ "B"sv, 55.70, 37.60 });
+        const geo::Coordinates point{ 55.60, 37.60 };
+
+        const auto throws = [&] {
+            bool thrown = false;
+            try {
+                catalogue.GetNearestStops(point, 1U);
+            }
+            catch (const std::logic_error&) {
+                thrown = true;
+            }
+            return thrown;
+        };
+        Check(throws(), "index is not built yet"sv, "A"sv);
+
+        catalogue.BuildStopsIndex();
+        const domain::NearbyStopsStat before = catalogue.GetNearestStops(point, 1U);
+        Check(before.size() == 1U && before.front().stop_name_ == "A"sv, "nearest stop"sv, "A"sv);
+
+        catalogue.UpdateStopCoordinates(catalogue.FindStopByName("A"sv), { 55.80, 37.60 });
+        Check(throws(), "nearest stops on a stale index"sv, "A"sv);
+        bool radius_thrown = false;
+        bool box_thrown = false;
+        try {
+            catalogue.GetStopsInRadius(point, 1000.0);
+        }
+        catch (const std::logic_error&) {
+            radius_thrown = true;
+        }
+        try {
+            catalogue.GetStopsInBox({ 55.0, 37.0 }, { 56.0, 38.0 });
+        }
+        catch (const std::logic_error&) {
+            box_thrown = true;
+        }
+        Check(radius_thrown && box_thrown, "radius and box on a stale index"sv, "A"sv);
+
+        catalogue.BuildStopsIndex();
+        const domain::NearbyStopsStat after = catalogue.GetNearestStops(point, 1U);
+        Check(after.size() == 1U && after.front().stop_name_ == "B"sv, "nearest stop after the move"sv, "B"sv);
+    }
+
+    // Новая остановка сбрасывает индекс имён: поиск и чтение порядка для базы бросают исключение
+    void TestStaleStopNamesIndex() {
+        transport_catalogue::TransportCatalogue catalogue;
+        catalogue.AddStop({ "Морской вокзал"sv, 55.60, 37.60 });
+        catalogue.BuildStopNamesIndex();
+        const domain::StopSearchStat found = catalogue.SearchStops("Мор"sv, 5U, 0U);
+        Check(found.size() == 1U, "prefix search"sv, "Мор"sv);
+
+        catalogue.AddStop({ "Морская улица"sv, 55.61, 37.60 });
+        bool search_thrown = false;
+        bool order_thrown = false;
+        try {
+            catalogue.SearchStops("Мор"sv, 5U, 0U);
+        }
+        catch (const std::logic_error&) {
+            search_thrown = true;
+        }
+        try {
+            catalogue.GetStopNamesIndex();
+        }
+        catch (const std::logic_error&) {
+            order_thrown = true;
+        }
+        Check(search_thrown && order_thrown, "stale names index"sv, "Мор"sv);
+
+        catalogue.BuildStopNamesIndex();
+        Check(catalogue.SearchStops("Мор"sv, 5U, 0U).size() == 2U, "prefix search after the rebuild"sv, "Мор"sv);
+    }
+
+}  // namespace
+
+int main() {
+    TestParallelAddBuses();
+    TestRouteRange();
+    TestReturnLegInCatalogue();
+    TestStaleStopsIndex();
+    TestStaleStopNamesIndex();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "catalogue_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+// Проверки distances::DistanceTable против std::map по направленной паре: прямое и обратное
+// направление, Add не заменяет заданное расстояние, Set заменяет, содержимое переживает рост таблицы
+
+#include "../distance_table.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <utility>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, uint32_t from, uint32_t to) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " for "sv << from << " -> "sv << to << '\n';
+            }
+        }
+    }
+
+    using Reference = std::map<std::pair<uint32_t, uint32_t>, uint32_t>;
+
+    uint32_t ReferenceDirected(const Reference& reference, uint32_t from, uint32_t to) {
+        const auto it = reference.find({ from, to });
+        return it != reference.end() ? it->second : 0U;
+    }
+
+    // Расстояние from -> to, если нет - to -> from, как у TransportCatalogue::GetDistance
+    uint32_t ReferenceGet(const Reference& reference, uint32_t from, uint32_t to) {
+        const uint32_t direct = ReferenceDirected(reference, from, to);
+        return direct != 0U ? direct : ReferenceDirected(reference, to, from);
+    }
+
+    void CheckTable(const distances::DistanceTable& table, const Reference& reference, uint32_t stops) {
+        Check(table.size() == reference.size(), "size"sv, 0U, 0U);
+
+        size_t visited = 0U;
+        table.ForEach([&](uint32_t from, uint32_t to, uint32_t distance) {
+            Check(ReferenceDirected(reference, from, to) == distance, "ForEach distance"sv, from, to);
+            ++visited;
+        });
+        Check(visited == reference.size(), "ForEach visits every distance once"sv, 0U, 0U);
+
+        for (uint32_t from = 0; from != stops; ++from) {
+            for (uint32_t to = 0; to != stops; ++to) {
+                Check(table.GetDirected(from, to) == ReferenceDirected(reference, from, to), "GetDirected"sv, from, to);
+                Check(table.Get(from, to) == ReferenceGet(reference, from, to), "Get"sv, from, to);
+            }
+        }
+    }
+
+    void TestDirections() {
+        distances::DistanceTable table;
+        Check(table.Get(1U, 2U) == 0U && table.GetDirected(1U, 2U) == 0U, "empty table"sv, 1U, 2U);
+
+        table.Add(1U, 2U, 500U);
+        Check(table.Get(1U, 2U) == 500U, "forward distance"sv, 1U, 2U);
+        Check(table.Get(2U, 1U) == 500U, "reverse falls back to forward"sv, 2U, 1U);
+        Check(table.GetDirected(2U, 1U) == 0U, "reverse is not set"sv, 2U, 1U);
+
+        table.Add(2U, 1U, 700U);
+        Check(table.Get(1U, 2U) == 500U && table.Get(2U, 1U) == 700U, "both directions"sv, 2U, 1U);
+
+        table.Add(1U, 2U, 900U);
+        Check(table.Get(1U, 2U) == 500U, "Add keeps the existing distance"sv, 1U, 2U);
+        table.Set(1U, 2U, 900U);
+        Check(table.Get(1U, 2U) == 900U && table.Get(2U, 1U) == 700U, "Set replaces one direction"sv, 1U, 2U);
+
+        // Расстояние от остановки до неё самой и нулевое расстояние
+        table.Add(3U, 3U, 100U);
+        Check(table.Get(3U, 3U) == 100U, "distance to itself"sv, 3U, 3U);
+        table.Add(4U, 5U, 0U);
+        Check(table.Get(4U, 5U) == 0U && table.size() == 3U, "zero distance is not stored"sv, 4U, 5U);
+    }
+
+    void TestAgainstMap() {
+        constexpr uint32_t STOPS = 300U;
+        std::mt19937 generator(31);
+        std::uniform_int_distribution<uint32_t> stop(0U, STOPS - 1);
+        std::uniform_int_distribution<uint32_t> distance(1U, 100000U);
+
+        distances::DistanceTable table;
+        Reference reference;
+        // Таблица растёт от 16 ячеек через несколько перестроений
+        for (int i = 0; i != 20000; ++i) {
+            const uint32_t from = stop(generator);
+            const uint32_t to = stop(generator);
+            const uint32_t value = distance(generator);
+            if (generator() % 4 == 0) {
+                table.Set(from, to, value);
+                reference[{ from, to }] = value;
+            }
+            else {
+                table.Add(from, to, value);
+                reference.emplace(std::make_pair(from, to), value);
+            }
+        }
+        CheckTable(table, reference, STOPS);
+
+        // Копия после перестроений отвечает так же
+        const distances::DistanceTable copy = table;
+        CheckTable(copy, reference, STOPS);
+    }
+
+}  // namespace
+
+int main() {
+    TestDirections();
+    TestAgainstMap();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "distance_table_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
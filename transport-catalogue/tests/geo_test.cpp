@@ -0,0 +1,95 @@
+// Проверки geo: округление координат к микроградусам и граница MAX_QUANTIZATION_ERROR
+
+#include "../geo.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, const geo::Coordinates& point) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " at "sv << point.lat << ", "sv << point.lng << '\n';
+            }
+        }
+    }
+
+    // Полшага сетки плюс погрешность деления на QUANTIZATION_SCALE
+    constexpr double MAX_AXIS_ERROR = 0.5 / geo::QUANTIZATION_SCALE + 1e-12;
+
+    void CheckRoundTrip(const geo::Coordinates& point) {
+        const geo::QuantizedCoordinates quantized = geo::Quantize(point);
+        const geo::Coordinates restored = geo::Dequantize(quantized);
+        Check(std::abs(restored.lat - point.lat) <= MAX_AXIS_ERROR, "latitude round trip"sv, point);
+        Check(std::abs(restored.lng - point.lng) <= MAX_AXIS_ERROR, "longitude round trip"sv, point);
+        // Точка сетки переходит сама в себя
+        Check(geo::Quantize(restored) == quantized, "quantization is idempotent"sv, point);
+    }
+
+    void TestRoundTripOverRange() {
+        std::mt19937_64 generator(37);
+        std::uniform_real_distribution<double> latitude(-90.0, 90.0);
+        std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+        for (int i = 0; i != 1000000; ++i) {
+            CheckRoundTrip({ latitude(generator), longitude(generator) });
+        }
+
+        // Границы диапазона и середины шагов сетки
+        for (const double lat : { -90.0, -89.9999995, -0.0000005, 0.0, 0.0000005, 89.9999995, 90.0 }) {
+            for (const double lng : { -180.0, -179.9999995, -0.0000005, 0.0, 0.0000005, 179.9999995, 180.0 }) {
+                CheckRoundTrip({ lat, lng });
+            }
+        }
+    }
+
+    // Расстояние между округлёнными точками отличается от исходного не более чем на
+    // MAX_QUANTIZATION_ERROR. Пары - в пределах города, от метра до сотни километров:
+    // ближе метра погрешность acos в ComputeDistance сама сравнима с границей
+    void TestDistanceErrorBound() {
+        std::mt19937_64 generator(41);
+        std::uniform_real_distribution<double> latitude(-80.0, 80.0);
+        std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+        std::uniform_real_distribution<double> exponent(-5.0, 0.0);
+        std::uniform_real_distribution<double> sign(-1.0, 1.0);
+
+        double worst = 0.0;
+        for (int i = 0; i != 1000000; ++i) {
+            const geo::Coordinates from{ latitude(generator), longitude(generator) };
+            const double step = std::pow(10.0, exponent(generator));
+            const geo::Coordinates to{ from.lat + sign(generator) * step, from.lng + sign(generator) * step };
+
+            const double exact = geo::ComputeDistance(from, to);
+            // Для почти совпадающих точек аргумент acos может превысить 1 - тогда exact не число
+            if (!(exact >= 1.0)) {
+                continue;
+            }
+            const double quantized = geo::ComputeDistance(geo::Dequantize(geo::Quantize(from)), geo::Dequantize(geo::Quantize(to)));
+            const double error = std::abs(quantized - exact);
+            worst = std::max(worst, error);
+            Check(error <= geo::MAX_QUANTIZATION_ERROR, "distance error bound"sv, from);
+        }
+        std::cout << "max distance error "sv << worst << " m, bound "sv << geo::MAX_QUANTIZATION_ERROR << " m\n"sv;
+    }
+
+}  // namespace
+
+int main() {
+    static_assert(sizeof(geo::QuantizedCoordinates) == 8);
+
+    TestRoundTripOverRange();
+    TestDistanceErrorBound();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "geo_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+// Проверки intersection::Intersect против std::set_intersection: списки близкого размера
+// (слияние блоками по 4), списки, отличающиеся больше чем в GALLOPING_RATIO раз
+// (галопирующий поиск), пустые и непересекающиеся списки
+
+#include "../intersection.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, size_t lhs_size, size_t rhs_size) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " for sizes "sv << lhs_size << " and "sv << rhs_size << '\n';
+            }
+        }
+    }
+
+    // size разных значений из [0, range) по возрастанию
+    std::vector<uint32_t> MakeList(std::mt19937& generator, size_t size, uint32_t range) {
+        std::vector<uint32_t> values(range);
+        for (uint32_t i = 0; i != range; ++i) {
+            values[i] = i;
+        }
+        std::shuffle(values.begin(), values.end(), generator);
+        values.resize(std::min<size_t>(size, range));
+        std::sort(values.begin(), values.end());
+        return values;
+    }
+
+    void CheckIntersection(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs, std::string_view what) {
+        std::vector<uint32_t> expected;
+        std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+
+        std::vector<uint32_t> result;
+        intersection::Intersect(lhs, rhs, result);
+        Check(result == expected, what, lhs.size(), rhs.size());
+
+        // Результат дописывается к уже имеющимся элементам
+        std::vector<uint32_t> appended{ 7U };
+        intersection::Intersect(rhs, lhs, appended);
+        Check(appended.size() == expected.size() + 1 && appended.front() == 7U
+            && std::equal(expected.begin(), expected.end(), appended.begin() + 1), what, rhs.size(), lhs.size());
+    }
+
+    void TestSimilarSizes() {
+        std::mt19937 generator(29);
+        for (size_t lhs_size : { 1U, 3U, 4U, 5U, 8U, 17U, 64U, 200U }) {
+            for (size_t rhs_size : { 1U, 4U, 7U, 16U, 33U, 128U }) {
+                for (int round = 0; round != 20; ++round) {
+                    CheckIntersection(MakeList(generator, lhs_size, 256U), MakeList(generator, rhs_size, 256U), "merge"sv);
+                }
+            }
+        }
+        // Совпадающие и сдвинутые на блок списки
+        std::vector<uint32_t> all(100);
+        for (uint32_t i = 0; i != all.size(); ++i) {
+            all[i] = i * 2;
+        }
+        CheckIntersection(all, all, "equal lists"sv);
+        CheckIntersection(all, std::vector<uint32_t>(all.begin() + 4, all.end()), "shifted lists"sv);
+    }
+
+    void TestGalloping() {
+        std::mt19937 generator(31);
+        for (size_t small_size : { 1U, 2U, 5U, 10U }) {
+            const size_t large_size = small_size * intersection::GALLOPING_RATIO + 1 + generator() % 500;
+            for (int round = 0; round != 50; ++round) {
+                const std::vector<uint32_t> large = MakeList(generator, large_size, 20000U);
+                // Половина короткого списка берётся из длинного, чтобы совпадения точно были
+                std::vector<uint32_t> small = MakeList(generator, small_size, 20000U);
+                for (size_t i = 0; i < small.size(); i += 2) {
+                    small[i] = large[generator() % large.size()];
+                }
+                std::sort(small.begin(), small.end());
+                small.erase(std::unique(small.begin(), small.end()), small.end());
+                CheckIntersection(small, large, "galloping"sv);
+            }
+        }
+        // Совпадения на краях длинного списка
+        std::vector<uint32_t> large(1000);
+        for (uint32_t i = 0; i != large.size(); ++i) {
+            large[i] = i;
+        }
+        CheckIntersection({ 0U, 999U }, large, "galloping at the edges"sv);
+        CheckIntersection({ 1000U, 2000U }, large, "galloping past the end"sv);
+    }
+
+    void TestEmptyAndDisjoint() {
+        const std::vector<uint32_t> empty;
+        const std::vector<uint32_t> some{ 1U, 5U, 9U, 12U, 40U };
+        CheckIntersection(empty, empty, "both empty"sv);
+        CheckIntersection(empty, some, "empty lhs"sv);
+        CheckIntersection(some, empty, "empty rhs"sv);
+        CheckIntersection(some, { 41U, 42U, 43U, 44U, 45U }, "disjoint ranges"sv);
+        CheckIntersection(some, { 2U, 6U, 10U, 13U, 39U }, "interleaved without matches"sv);
+    }
+
+}  // namespace
+
+int main() {
+    TestSimilarSizes();
+    TestGalloping();
+    TestEmptyAndDisjoint();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "intersection_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+// Проверки JSON: json::Load и документ на арене json::arena::Document должны одинаково
+// принимать корректный вход и одинаково отвергать ошибочный, а потоковый json::Writer -
+// выводить байт в байт то же, что json::Print
+
+#include "../json.h"
+#include "../json_arena.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <variant>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, std::string_view text) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " for "sv << text << '\n';
+            }
+        }
+    }
+
+    // Строка из JSON-текста, разобранная обоими способами; из потока - тем же, что из буфера
+    void CheckString(std::string_view text, std::string_view expected) {
+        try {
+            Check(json::Load(text).GetRoot().AsString() == expected, "json::Load string"sv, text);
+            std::istringstream input{ std::string(text) };
+            Check(json::Load(input).GetRoot().AsString() == expected, "json::Load from stream"sv, text);
+            json::arena::Document document;
+            Check(document.Load(text).AsString() == expected, "arena string"sv, text);
+        }
+        catch (const std::exception& error) {
+            Check(false, error.what(), text);
+        }
+    }
+
+    // Ошибочный вход: оба разбора бросают json::ParsingError
+    void CheckRejected(std::string_view text) {
+        bool rejected = false;
+        try {
+            json::Load(text);
+        }
+        catch (const json::ParsingError&) {
+            rejected = true;
+        }
+        Check(rejected, "json::Load rejects"sv, text);
+
+        rejected = false;
+        try {
+            json::arena::Document document;
+            document.Load(text);
+        }
+        catch (const json::ParsingError&) {
+            rejected = true;
+        }
+        Check(rejected, "arena rejects"sv, text);
+    }
+
+    void TestEscapes() {
+        CheckString(R"("plain")"sv, "plain"sv);
+        CheckString(R"("")"sv, ""sv);
+        CheckString(R"("quote \" backslash \\ slash \/")"sv, "quote \" backslash \\ slash /"sv);
+        CheckString(R"("\b\f\n\r\t")"sv, "\b\f\n\r\t"sv);
+        CheckString(R"("Улица Лизы Чайкиной")"sv, "Улица Лизы Чайкиной"sv);
+
+        // \uXXXX раскодируется в UTF-8 длиной 1, 2 и 3 байта
+        CheckString(R"("\u0041\u00e9\u20ac")"sv, "A\xC3\xA9\xE2\x82\xAC"sv);
+        CheckString(R"("\u0423\u043B\u0438\u0446\u0430")"sv, "Улица"sv);
+        // Суррогатная пара - один символ вне BMP, 4 байта UTF-8
+        CheckString(R"("smile \ud83d\ude00!")"sv, "smile \xF0\x9F\x98\x80!"sv);
+        CheckString(R"("\uD834\uDD1E")"sv, "\xF0\x9D\x84\x9E"sv);
+
+        CheckRejected(R"("\x")"sv);
+        CheckRejected(R"("\u12")"sv);
+        CheckRejected(R"("\u12G4")"sv);
+        // Непарные суррогаты
+        CheckRejected(R"("\ud83d")"sv);
+        CheckRejected(R"("\ud83dA")"sv);
+        CheckRejected(R"("\ude00")"sv);
+        CheckRejected(R"("unterminated)"sv);
+        CheckRejected("\"line\nbreak\""sv);
+    }
+
+    // Корень-скаляр обоими разборами: целое остаётся int, остальное - double
+    void CheckNumber(std::string_view text, bool is_int, double expected) {
+        try {
+            const json::Document document = json::Load(text);
+            const json::Node& node = document.GetRoot();
+            Check(node.IsInt() == is_int && node.IsPureDouble() == !is_int, "json::Load number type"sv, text);
+            Check(node.AsDouble() == expected && (!is_int || node.AsInt() == expected), "json::Load number value"sv, text);
+
+            json::arena::Document arena_document;
+            const json::arena::Node& arena_node = arena_document.Load(text);
+            Check(arena_node.IsInt() == is_int && arena_node.IsPureDouble() == !is_int, "arena number type"sv, text);
+            Check(arena_node.AsDouble() == expected && (!is_int || arena_node.AsInt() == expected), "arena number value"sv, text);
+        }
+        catch (const std::exception& error) {
+            Check(false, error.what(), text);
+        }
+    }
+
+    void TestLeadingZerosAndTrailingInput() {
+        CheckNumber("0"sv, true, 0.0);
+        CheckNumber("-0"sv, true, 0.0);
+        CheckNumber("10"sv, true, 10.0);
+        CheckNumber("0.25"sv, false, 0.25);
+        CheckNumber("-0.5e1"sv, false, -5.0);
+        CheckNumber(" \t\r\n7 \n"sv, true, 7.0);
+
+        CheckRejected("01"sv);
+        CheckRejected("-01"sv);
+        CheckRejected("00.5"sv);
+        CheckRejected("[1, 02]"sv);
+        CheckRejected(R"({"a": 007})"sv);
+
+        // После корневого значения - только пробельные символы
+        CheckRejected("1 2"sv);
+        CheckRejected("[1]]"sv);
+        CheckRejected("{} x"sv);
+        CheckRejected(R"("a" "b")"sv);
+        CheckRejected("null,"sv);
+        CheckRejected("true false"sv);
+        CheckRejected(""sv);
+        CheckRejected("  "sv);
+    }
+
+    // Целое вне диапазона int читается как double, а не обрезается и не отвергается
+    void TestIntOverflow() {
+        CheckNumber("2147483647"sv, true, 2147483647.0);
+        CheckNumber("-2147483648"sv, true, -2147483648.0);
+        CheckNumber("2147483648"sv, false, 2147483648.0);
+        CheckNumber("-2147483649"sv, false, -2147483649.0);
+        CheckNumber("3000000000"sv, false, 3e9);
+        CheckNumber("123456789012345678901234567890"sv, false, 123456789012345678901234567890.0);
+
+        // Так же внутри контейнера и через потоковое чтение Parser::ReadNumber
+        const json::Document document = json::Load("[3000000000, 42]"sv);
+        const json::Array& array = document.GetRoot().AsArray();
+        Check(array.at(0).IsPureDouble() && array.at(0).AsDouble() == 3e9 && array.at(1).IsInt(),
+            "overflow inside an array"sv, "[3000000000, 42]"sv);
+
+        json::Parser parser("3000000000"sv);
+        const std::variant<int, double> number = parser.ReadNumber();
+        Check(std::holds_alternative<double>(number) && std::get<double>(number) == 3e9,
+            "Parser::ReadNumber overflow"sv, "3000000000"sv);
+    }
+
+    // SkipValue возвращает текст значения и оставляет позицию сразу за ним
+    void CheckSkipped(std::string_view text, std::string_view expected) {
+        try {
+            json::Parser parser(text);
+            Check(parser.SkipValue() == expected, "SkipValue text"sv, text);
+        }
+        catch (const std::exception& error) {
+            Check(false, error.what(), text);
+        }
+    }
+
+    void CheckSkipRejected(std::string_view text) {
+        bool rejected = false;
+        try {
+            json::Parser parser(text);
+            parser.SkipValue();
+        }
+        catch (const json::ParsingError&) {
+            rejected = true;
+        }
+        Check(rejected, "SkipValue rejects"sv, text);
+    }
+
+    void TestSkipValue() {
+        CheckSkipped(R"(  "text" , 1)"sv, R"("text")"sv);
+        CheckSkipped(R"("a\"b\\", 1)"sv, R"("a\"b\\")"sv);
+        CheckSkipped("-12.5e3]"sv, "-12.5e3"sv);
+        CheckSkipped(R"([1, "]", {"}": "[\"{"}], 2)"sv, R"([1, "]", {"}": "[\"{"}])"sv);
+
+        // Контейнеры длиннее блока: обратная косая черта и кавычка на каждой позиции относительно его границы
+        for (size_t pad = 0; pad != 140U; ++pad) {
+            const std::string letters(pad, 'a');
+            const std::string escaped_quote = R"([{"k": ")"s + letters + R"(\"]}"}, 1])"s;
+            CheckSkipped(escaped_quote + ", 2"s, escaped_quote);
+            const std::string escaped_backslash = R"([{"k": ")"s + letters + R"(\\"}, "]"])"s;
+            CheckSkipped(escaped_backslash + "]"s, escaped_backslash);
+            CheckSkipRejected(R"([")"s + letters + R"(\"])"s);
+        }
+
+        // Обратная косая черта - последний символ буфера: за его концом лежит продолжение строки,
+        // и выход за конец дал бы значение вместо ошибки
+        const std::string buffer = R"("abc\" tail")"s;
+        CheckSkipRejected(std::string_view(buffer).substr(0, 5U));
+        CheckSkipRejected(std::string_view(R"(["abc\" tail"])"sv).substr(0, 6U));
+        CheckSkipRejected(R"("unterminated)"sv);
+        CheckSkipRejected("[1, [2]"sv);
+        CheckSkipRejected(""sv);
+    }
+
+    // Документ, который Writer пишет вызовами в TestWriterMatchesPrint; ключи по алфавиту, как в json::Dict
+    constexpr std::string_view NESTED = R"({
+        "array": [1, -2, 0.1, 2.5e+21, true, false, null, "text", [], {}],
+        "empty": "",
+        "escaped": "quote \" backslash \\ line\nreturn\r tab\t",
+        "nested": {"inner": [{"id": 7, "name": "Морской вокзал"}], "ratio": -0.000123456789},
+        "number": 2147483647
+    })"sv;
+
+    void WriteNested(json::Writer& writer) {
+        writer.StartDict()
+            .Key("array"sv).StartArray()
+                .Value(1).Value(-2).Value(0.1).Value(2.5e21).Value(true).Value(false).Value(nullptr).Value("text")
+                .StartArray().EndArray()
+                .StartDict().EndDict()
+            .EndArray()
+            .Key("empty"sv).Value(""sv)
+            .Key("escaped"sv).Value("quote \" backslash \\ line\nreturn\r tab\t"sv)
+            .Key("nested"sv).StartDict()
+                .Key("inner"sv).StartArray()
+                    .StartDict().Key("id"sv).Value(7).Key("name"sv).Value("Морской вокзал"s).EndDict()
+                .EndArray()
+                .Key("ratio"sv).Value(-0.000123456789)
+            .EndDict()
+            .Key("number"sv).Value(2147483647)
+        .EndDict();
+    }
+
+    void TestWriterMatchesPrint() {
+        const json::Document document = json::Load(NESTED);
+        for (const json::DoubleFormat format : { json::DoubleFormat::stream, json::DoubleFormat::shortest }) {
+            const std::string_view name = format == json::DoubleFormat::stream ? "stream format"sv : "shortest format"sv;
+
+            std::ostringstream printed;
+            json::Print(document, printed, format);
+
+            std::ostringstream written;
+            {
+                json::Writer writer(written, format);
+                WriteNested(writer);
+            }
+            Check(written.str() == printed.str(), "Writer calls equal Print"sv, name);
+
+            // Узел целиком и корень-скаляр
+            std::ostringstream node_written;
+            {
+                json::Writer writer(node_written, format);
+                writer.Value(document.GetRoot());
+            }
+            Check(node_written.str() == printed.str(), "Writer::Value(Node) equals Print"sv, name);
+
+            std::ostringstream scalar_printed;
+            json::Print(json::Document{ json::Node{ 0.5 } }, scalar_printed, format);
+            std::ostringstream scalar_written;
+            json::Writer(scalar_written, format).Value(0.5);
+            Check(scalar_written.str() == scalar_printed.str(), "scalar root"sv, name);
+        }
+    }
+
+}  // namespace
+
+int main() {
+    TestEscapes();
+    TestWriterMatchesPrint();
+    TestLeadingZerosAndTrailingInput();
+    TestIntOverflow();
+    TestSkipValue();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "json_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
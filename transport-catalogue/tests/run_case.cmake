@@ -0,0 +1,32 @@
+# Прогон одного набора из tests/data: make_base по общей базе, update_base (если в наборе
+# есть файл), process_requests набора и сравнение result.json с expected.json побайтно.
+# Параметры: BINARY - путь к программе, BASE_FILE - make_base.json общей базы,
+# CASE_DIR - каталог набора, WORK_DIR - рабочий каталог.
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(GLOB INPUT_FILES "${CASE_DIR}/*.json")
+file(COPY ${INPUT_FILES} DESTINATION "${WORK_DIR}")
+file(COPY "${BASE_FILE}" DESTINATION "${WORK_DIR}")
+
+set(MODES make_base)
+if(EXISTS "${CASE_DIR}/update_base.json")
+    list(APPEND MODES update_base)
+endif()
+list(APPEND MODES process_requests)
+
+foreach(MODE ${MODES})
+    execute_process(COMMAND "${BINARY}" ${MODE}
+                    WORKING_DIRECTORY "${WORK_DIR}"
+                    RESULT_VARIABLE EXIT_CODE)
+    if(NOT EXIT_CODE EQUAL 0)
+        message(FATAL_ERROR "${MODE} failed with code ${EXIT_CODE}")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                        "${WORK_DIR}/result.json" "${CASE_DIR}/expected.json"
+                RESULT_VARIABLE DIFFERENT)
+if(DIFFERENT)
+    message(FATAL_ERROR "result.json differs from ${CASE_DIR}/expected.json")
+endif()
@@ -0,0 +1,180 @@
+// Проверки снимков каталога: читатели видят согласованные версии, пока писатель
+// применяет изменения, а удержанный снимок не меняется после публикации следующих
+
+#include "../request_handler.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    std::atomic<int> failures = 0;
+
+    void Check(bool condition, std::string_view what, uint64_t version) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " in version "sv << version << '\n';
+            }
+        }
+    }
+
+    // Остановки на одной линии через SEGMENT метров; маршрут "1" сначала идёт по первым двум,
+    // каждая публикация добавляет в его конец следующую
+    constexpr size_t STOPS = 40U;
+    constexpr size_t SEGMENT = 1000U;
+    constexpr int READERS = 4;
+
+    std::string StopName(size_t index) {
+        return "Stop "s + std::to_string(index);
+    }
+
+    void BuildBase(request_handler::RequestHandler& handler) {
+        domain::RequestsMap requests;
+        domain::RequestsList& stops = requests[domain::RequestType::add_stop];
+        for (size_t i = 0; i != STOPS; ++i) {
+            domain::Request stop;
+            stop.type_ = domain::RequestType::add_stop;
+            stop.name_ = StopName(i);
+            stop.coordinates_ = { 55.0 + 0.01 * static_cast<double>(i), 37.0 };
+            if (i + 1 != STOPS) {
+                stop.distances_.emplace(StopName(i + 1), static_cast<int64_t>(SEGMENT));
+            }
+            stops.push_back(std::move(stop));
+        }
+        domain::Request bus;
+        bus.type_ = domain::RequestType::add_bus;
+        bus.name_ = "1";
+        bus.is_circular_ = false;
+        bus.stops_.emplace_back(StopName(0));
+        bus.stops_.emplace_back(StopName(1));
+        requests[domain::RequestType::add_bus].push_back(std::move(bus));
+
+        handler.HandleBaseRequests(std::move(requests));
+        // 30 км/ч - 500 м в минуту, перегон занимает 2 минуты
+        handler.SetRouterSettings({ 2U, 30.0 });
+        handler.InitializeTransportRouterGraph();
+    }
+
+    void ExtendBus(request_handler::RequestHandler& handler, size_t stop_index) {
+        domain::RequestsList requests;
+        domain::Request update;
+        update.type_ = domain::RequestType::add_stop_to_bus;
+        update.name_ = "1";
+        update.stops_.emplace_back(StopName(stop_index));
+        requests.push_back(std::move(update));
+        handler.HandleUpdateRequests(requests);
+    }
+
+    // В версии v маршрут проходит остановки 0..v; все ответы снимка выводятся из номера версии
+    void CheckSnapshot(const transport_catalogue::snapshot::CatalogueSnapshot& snapshot) {
+        const uint64_t version = snapshot.GetVersion();
+        const size_t last = static_cast<size_t>(version);
+
+        const domain::BusStat* bus = snapshot.GetBus("1"sv);
+        Check(bus != nullptr, "bus is found"sv, version);
+        if (bus != nullptr) {
+            Check(bus->unique_stops_num_ == last + 1, "unique stops"sv, version);
+            Check(bus->bus_stops_num_ == 2 * last + 1, "stops on route"sv, version);
+            Check(bus->route_length_ == 2 * last * SEGMENT, "route length"sv, version);
+        }
+
+        const domain::StopStat* stop = snapshot.GetStop(StopName(last));
+        Check(stop != nullptr && stop->buses_.size() == 1U, "last stop is served"sv, version);
+        if (last + 1 != STOPS) {
+            const domain::StopStat* next = snapshot.GetStop(StopName(last + 1));
+            Check(next != nullptr && next->buses_.size() == 0U, "next stop is not served yet"sv, version);
+        }
+
+        const domain::RouteStat route = snapshot.GetRoute(StopName(0), StopName(last));
+        // Время складывается из перегонов, поэтому сравнивается с допуском
+        Check(route.is_found_ && std::abs(route.total_time_ - (2.0 + 2.0 * static_cast<double>(last))) < 1e-9, "route to last stop"sv, version);
+        if (last + 1 != STOPS) {
+            Check(!snapshot.GetRoute(StopName(0), StopName(last + 1)).is_found_, "no route past the end"sv, version);
+        }
+    }
+
+    void TestConcurrentReaders() {
+        request_handler::RequestHandler handler;
+        BuildBase(handler);
+        handler.PublishSnapshot();
+
+        const auto first = handler.GetSnapshot();
+        Check(first->GetVersion() == 1U, "first version"sv, first->GetVersion());
+        CheckSnapshot(*first);
+
+        std::atomic<bool> done = false;
+        std::vector<std::thread> readers;
+        for (int i = 0; i != READERS; ++i) {
+            readers.emplace_back([&handler, &done] {
+                uint64_t seen = 0U;
+                while (!done.load()) {
+                    const auto snapshot = handler.GetSnapshot();
+                    // Версии не идут назад, и каждая целиком отвечает своему номеру
+                    Check(snapshot->GetVersion() >= seen, "versions are monotonic"sv, snapshot->GetVersion());
+                    seen = snapshot->GetVersion();
+                    CheckSnapshot(*snapshot);
+                }
+            });
+        }
+
+        for (size_t i = 2; i != STOPS; ++i) {
+            ExtendBus(handler, i);
+            handler.PublishSnapshot();
+        }
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        const auto last = handler.GetSnapshot();
+        Check(last->GetVersion() == STOPS - 1, "last version"sv, last->GetVersion());
+        CheckSnapshot(*last);
+        // Удержанный с начала снимок отвечает как до изменений
+        CheckSnapshot(*first);
+    }
+
+    void TestFailedUpdateKeepsSnapshot() {
+        request_handler::RequestHandler handler;
+        BuildBase(handler);
+        handler.PublishSnapshot();
+        const auto before = handler.GetSnapshot();
+
+        domain::RequestsList requests;
+        domain::Request update;
+        update.type_ = domain::RequestType::add_stop_to_bus;
+        update.name_ = "1";
+        update.stops_.emplace_back("Unknown stop");
+        requests.push_back(std::move(update));
+
+        bool thrown = false;
+        try {
+            handler.HandleUpdateRequests(requests);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        Check(thrown, "unknown stop is rejected"sv, before->GetVersion());
+        Check(handler.GetSnapshot() == before, "published snapshot is kept"sv, before->GetVersion());
+        CheckSnapshot(*before);
+    }
+
+}  // namespace
+
+int main() {
+    TestConcurrentReaders();
+    TestFailedUpdateKeepsSnapshot();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "snapshot_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
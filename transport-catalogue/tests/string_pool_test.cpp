@@ -0,0 +1,148 @@
+// Проверки names::StringPool и perfect_hash::MinimalPerfectHash: функция взаимно однозначна
+// на своих ключах, переживает сохранение и восстановление, а чужие имена отвергаются -
+// большинство по отпечатку, остальные сравнением строк
+
+#include "../string_pool.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+    int failures = 0;
+
+    void Check(bool condition, std::string_view what, std::string_view name) {
+        if (!condition) {
+            if (++failures <= 10) {
+                std::cerr << "FAILED: "sv << what << " for \""sv << name << "\"\n"sv;
+            }
+        }
+    }
+
+    std::vector<std::string> MakeNames(size_t count) {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i != count; ++i) {
+            names.push_back((i % 2 == 0 ? "Остановка "s : "Bus "s) + std::to_string(i));
+        }
+        return names;
+    }
+
+    void TestIntern() {
+        names::StringPool pool;
+        const std::vector<std::string> names = MakeNames(50000U);
+        std::vector<std::string_view> stored;
+        for (size_t i = 0; i != names.size(); ++i) {
+            Check(pool.Intern(names[i]) == i, "ids are dense"sv, names[i]);
+            stored.push_back(pool.Get(static_cast<names::NameId>(i)));
+        }
+        // Имя длиннее блока арены
+        const std::string long_name(100000U, 'x');
+        const names::NameId long_id = pool.Intern(long_name);
+
+        for (size_t i = 0; i != names.size(); ++i) {
+            Check(pool.Intern(names[i]) == i, "repeated name keeps its id"sv, names[i]);
+            // Блоки не перемещаются: выданные ранее string_view остаются действительными
+            Check(stored[i] == names[i] && stored[i].data() == pool.Get(static_cast<names::NameId>(i)).data(),
+                "stored view is stable"sv, names[i]);
+        }
+        Check(pool.Get(long_id) == long_name, "long name"sv, "x..."sv);
+        Check(!pool.Find("Остановка 1"sv), "unknown name"sv, "Остановка 1"sv);
+    }
+
+    void TestPerfectHash() {
+        const std::vector<std::string> names = MakeNames(20000U);
+        const std::vector<std::string_view> keys(names.begin(), names.end());
+        perfect_hash::MinimalPerfectHash hash;
+        hash.Build(keys);
+        Check(hash.size() == keys.size(), "one slot per key"sv, ""sv);
+
+        std::vector<bool> seen(keys.size(), false);
+        for (size_t i = 0; i != keys.size(); ++i) {
+            const std::optional<uint32_t> index = hash.Lookup(keys[i]);
+            Check(index && *index == i, "key maps to its index"sv, keys[i]);
+            if (index && *index < seen.size()) {
+                Check(!seen[*index], "indices are distinct"sv, keys[i]);
+                seen[*index] = true;
+            }
+        }
+
+        // Чужие ключи: кандидата с совпавшим 16-битным отпечатком получает около 1/65536 из них
+        size_t candidates = 0U;
+        constexpr size_t UNKNOWN = 200000U;
+        for (size_t i = 0; i != UNKNOWN; ++i) {
+            if (hash.Lookup("Unknown "s + std::to_string(i))) {
+                ++candidates;
+            }
+        }
+        Check(candidates * 1000U < UNKNOWN, "fingerprint rejects unknown keys"sv, "Unknown"sv);
+    }
+
+    void TestRestore() {
+        names::StringPool pool;
+        const std::vector<std::string> names = MakeNames(5000U);
+        for (const std::string& name : names) {
+            pool.Intern(name);
+        }
+        pool.BuildPerfectHash();
+
+        // Так функция пишется в базу и читается из неё
+        const perfect_hash::MinimalPerfectHash& built = pool.GetPerfectHash();
+        std::vector<std::string_view> saved_names;
+        for (names::NameId id = 0; id != pool.size(); ++id) {
+            saved_names.push_back(pool.Get(id));
+        }
+        names::StringPool restored;
+        restored.Restore(saved_names, { built.GetSeed(), built.GetDisplacements(), built.GetSlots(), built.GetFingerprints() });
+        Check(!restored.GetPerfectHash().empty(), "hash is restored"sv, ""sv);
+
+        for (size_t i = 0; i != names.size(); ++i) {
+            const std::optional<names::NameId> id = restored.Find(names[i]);
+            Check(id && *id == i, "restored name keeps its id"sv, names[i]);
+        }
+
+        // Чужое имя с совпавшим отпечатком отвергается сравнением строк
+        std::string collision;
+        for (size_t i = 0; i != 10000000U && collision.empty(); ++i) {
+            std::string candidate = "Unknown "s + std::to_string(i);
+            if (restored.GetPerfectHash().Lookup(candidate)) {
+                collision = std::move(candidate);
+            }
+        }
+        Check(!collision.empty(), "fingerprint collision is found"sv, ""sv);
+        Check(!restored.Find(collision), "unknown name with a matching fingerprint"sv, collision);
+
+        // Новое имя сбрасывает функцию, прежние имена находятся через обычный индекс
+        const names::NameId added = restored.Intern("Новая остановка"sv);
+        Check(added == names.size() && restored.GetPerfectHash().empty(), "new name drops the hash"sv, "Новая остановка"sv);
+        Check(restored.Find(names.front()) == names::NameId{ 0 } && restored.Find("Новая остановка"sv) == added,
+            "index after the hash is dropped"sv, names.front());
+
+        // Функция от другого набора имён не принимается
+        names::StringPool mismatched;
+        saved_names.pop_back();
+        mismatched.Restore(saved_names, { built.GetSeed(), built.GetDisplacements(), built.GetSlots(), built.GetFingerprints() });
+        Check(mismatched.GetPerfectHash().empty(), "mismatched hash is dropped"sv, ""sv);
+        Check(mismatched.Find(names[1]) == names::NameId{ 1 }, "index for mismatched hash"sv, names[1]);
+    }
+
+}  // namespace
+
+int main() {
+    TestIntern();
+    TestPerfectHash();
+    TestRestore();
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n"sv;
+        return EXIT_FAILURE;
+    }
+    std::cout << "string_pool_test OK\n"sv;
+    return EXIT_SUCCESS;
+}
@@ -2,187 +2,535 @@
 
 namespace transport_catalogue {
 
-	void TransportCatalogue::ComputeRouteLength(Bus& route)
-	{
-		const auto& stops_ref = route.GetStops();
-		//Вычисляем длину маршрута двумя способами
-		route.geo_route_length_ = std::transform_reduce(
-			stops_ref.begin(),
-			stops_ref.end() - 1,
-			stops_ref.begin() + 1,
-			0.0,
-			std::plus<double>(),
-			[](const auto stop_l, const auto stop_r) {
-				return geo::ComputeDistance(stop_l->coordinates_, stop_r->coordinates_);
-			});
-		route.real_route_length_ = std::transform_reduce(
-			stops_ref.begin(),
-			stops_ref.end() - 1,
-			stops_ref.begin() + 1,
-			0ULL,
-			std::plus<size_t>(),
-			[&](const auto stop_l, const auto stop_r) {
-				return GetDistance(stop_l, stop_r);
-			});
+	void TransportCatalogue::ComputeRouteLength(Bus& route) const
+	{
+		// Обратный ход некольцевого маршрута проходится через представление, расстояния
+		// на нём берутся в обратном направлении
+		const auto stops_ref = route.GetRouteStops();
+		//Вычисляем длину маршрута двумя способами.
+		//Расстояния по прямой считаются пачками по таблице тригонометрии остановок
+		//и складываются в прежнем порядке, поэтому длина не зависит от размера пачки
+		constexpr size_t BATCH_SIZE = 64U;
+		uint32_t from[BATCH_SIZE];
+		uint32_t to[BATCH_SIZE];
+		double distances[BATCH_SIZE];
+		double geo_length = 0.0;
+		size_t real_length = 0U;
+		for (size_t first = 1; first < stops_ref.size(); first += BATCH_SIZE) {
+			const size_t count = std::min(BATCH_SIZE, stops_ref.size() - first);
+			for (size_t i = 0; i != count; ++i) {
+				const Stop* from_stop = stops_ref[first + i - 1];
+				const Stop* to_stop = stops_ref[first + i];
+				from[i] = from_stop->id_;
+				to[i] = to_stop->id_;
+				real_length += GetDistance(from_stop, to_stop);
+			}
+			stops_trigonometry_.ComputeDistances(from, to, count, distances);
+			for (size_t i = 0; i != count; ++i) {
+				geo_length += distances[i];
+			}
+		}
+		route.geo_route_length_ = geo_length;
+		route.real_route_length_ = real_length;
 		//Вычисляем извилистость
 		route.route_curvature_ = route.real_route_length_ / route.geo_route_length_;
 	}
 
+	std::unique_ptr<TransportCatalogue> TransportCatalogue::Clone() const
+	{
+		auto result = std::make_unique<TransportCatalogue>();
+
+		// Имена переносятся в прежнем порядке вместе с совершенной хеш-функцией,
+		// поэтому id имён, остановок и маршрутов в копии те же
+		std::vector<std::string_view> names;
+		names.reserve(names_pool_.size());
+		for (names::NameId id = 0; id != names_pool_.size(); ++id) {
+			names.push_back(names_pool_.Get(id));
+		}
+		result->names_pool_.Restore(names, perfect_hash::MinimalPerfectHash(names_pool_.GetPerfectHash()));
+		result->name_to_stop_ = name_to_stop_;
+		result->name_to_bus_ = name_to_bus_;
+
+		for (const Stop& stop : stops_data_) {
+			result->_all_stops_to_router.push_back(&result->stops_data_.emplace_back(stop));
+		}
+		for (const Bus& bus : routes_data_) {
+			Bus& bus_ref = result->routes_data_.emplace_back(bus);
+			for (Stop*& stop : bus_ref.stops_) {
+				stop = result->_all_stops_to_router[stop->id_];
+			}
+			result->_all_buses_to_router.push_back(&bus_ref);
+		}
+
+		// Имена остановок и маршрутов переводятся в пул копии
+		for (names::NameId id = 0; id != name_to_stop_.size(); ++id) {
+			if (name_to_stop_[id] != NO_ID) {
+				result->stops_data_[name_to_stop_[id]].name_ = result->names_pool_.Get(id);
+			}
+			if (name_to_bus_[id] != NO_ID) {
+				result->routes_data_[name_to_bus_[id]].bus_name_ = result->names_pool_.Get(id);
+			}
+		}
+		result->stops_names_.reserve(stops_data_.size());
+		for (const Stop& stop : result->stops_data_) {
+			result->stops_names_.push_back(stop.name_);
+		}
+
+		result->stops_distances_ = stops_distances_;
+		result->stop_buses_index_ = stop_buses_index_;
+		result->coordinates_quantized_ = coordinates_quantized_;
+		result->stops_coordinates_ = stops_coordinates_;
+		result->stops_quantized_coordinates_ = stops_quantized_coordinates_;
+		result->stops_trigonometry_ = stops_trigonometry_;
+		result->buses_stops_ = buses_stops_;
+		result->buses_stops_offsets_ = buses_stops_offsets_;
+		result->stops_index_ = stops_index_;
+		result->stops_index_ready_ = stops_index_ready_;
+		result->stop_names_index_ = stop_names_index_;
+		result->stop_names_index_ready_ = stop_names_index_ready_;
+		return result;
+	}
+
 	void TransportCatalogue::AddStop(Stop&& stop)
 	{
-		if (!stopnames_to_stops_.count(stop.name_)) {
+		if (FindStopByName(stop.name_) == nullptr) {
 
+			stop.id_ = static_cast<StopId>(stops_data_.size());
+			const names::NameId name_id = AddName(stop.name_);
+			stop.name_ = names_pool_.Get(name_id);
+			name_to_stop_[name_id] = stop.id_;
 			Stop& stop_ref = stops_data_.emplace_back(std::move(stop));
+			stop_buses_index_.emplace_back();
 
 			_all_stops_to_router.push_back(&stop_ref);
-
-			stopnames_to_stops_.insert({ std::string_view(stop_ref.name_), &stop_ref });
+			if (coordinates_quantized_) {
+				// остановка получает координаты, совпадающие с сохраняемыми в базу,
+				// поэтому длины маршрутов одинаковы при создании базы и после загрузки
+				const geo::QuantizedCoordinates quantized = geo::Quantize(stop_ref.coordinates_);
+				stop_ref.coordinates_ = geo::Dequantize(quantized);
+				stops_quantized_coordinates_.push_back(quantized);
+			}
+			else {
+				stops_coordinates_.push_back(stop_ref.coordinates_);
+			}
+			stops_trigonometry_.PushBack(stop_ref.coordinates_);
+			stops_names_.push_back(stop_ref.name_);
+			answers_ready_ = false;
+			stops_index_ready_ = false;
+			stop_names_index_ready_ = false;
 		}
 	}
 
 	void TransportCatalogue::AddBus(Bus&& bus)
 	{
-		if (!routenames_to_routes_.count(bus.bus_name_)) {
-			//Заполненяем контейнеры маршрутами
-			Bus& bus_ref = routes_data_.emplace_back(std::move(bus));
-
-			_all_buses_to_router.push_back(&bus_ref);
-
-			routenames_to_routes_.insert({ std::string_view(bus_ref.bus_name_), &bus_ref });
+		if (Bus* bus_ptr = InsertBus(std::move(bus))) {
+			ComputeBusStats(*bus_ptr);
+		}
+	}
 
-			//Находим уникальные остоновки
-			std::vector<Stop*> tmp = bus_ref.stops_;
-			std::sort(tmp.begin(), tmp.end());
-			auto last = std::unique(tmp.begin(), tmp.end());
+	void TransportCatalogue::AddBuses(std::vector<Bus>&& buses, size_t threads)
+	{
+		// Сначала все маршруты вставляются последовательно: выдаются id, заполняются индексы
+		std::vector<Bus*> inserted;
+		inserted.reserve(buses.size());
+		for (Bus& bus : buses) {
+			if (Bus* bus_ptr = InsertBus(std::move(bus))) {
+				inserted.push_back(bus_ptr);
+			}
+		}
 
-			bus_ref.unique_stops_ = (last != tmp.end() ? std::distance(tmp.begin(), last) : tmp.size());
+		// Статистика каждого маршрута зависит только от него самого и неизменяемых
+		// к этому моменту остановок и расстояний, поэтому считается параллельно по частям
+		if (threads == 0U) {
+			threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+		const size_t chunks = std::min(threads, inserted.size() / MIN_BUSES_PER_TASK);
+		if (chunks < 2) {
+			for (Bus* bus_ptr : inserted) {
+				ComputeBusStats(*bus_ptr);
+			}
+			return;
+		}
 
-			//Проверяем тип маршрута
-			if (!bus_ref.is_circular_) {
-				for (int i = static_cast<int>(bus_ref.stops_.size()) - 2; i >= 0; --i) {
-					bus_ref.stops_.push_back(bus_ref.stops_[i]);
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(chunks);
+		const size_t chunk_size = (inserted.size() + chunks - 1) / chunks;
+		for (size_t first = 0; first < inserted.size(); first += chunk_size) {
+			const size_t last = std::min(first + chunk_size, inserted.size());
+			tasks.push_back(std::async(std::launch::async, [this, &inserted, first, last]() {
+				for (size_t i = first; i != last; ++i) {
+					ComputeBusStats(*inserted[i]);
 				}
-			}
+				}));
+		}
+		for (auto& task : tasks) {
+			task.get();
+		}
+	}
 
-			// Рассчитываем длинну маршрута
-			if (bus_ref.stops_.size() > 1) {
-				TransportCatalogue::ComputeRouteLength(bus_ref);
-			}
+	Bus* TransportCatalogue::InsertBus(Bus&& bus)
+	{
+		if (FindRouteByName(bus.bus_name_) != nullptr) {
+			return nullptr;
 		}
 
+		//Заполненяем контейнеры маршрутами
+		bus.id_ = static_cast<BusId>(routes_data_.size());
+		const names::NameId name_id = AddName(bus.bus_name_);
+		bus.bus_name_ = names_pool_.Get(name_id);
+		name_to_bus_[name_id] = bus.id_;
+		Bus& bus_ref = routes_data_.emplace_back(std::move(bus));
+
+		_all_buses_to_router.push_back(&bus_ref);
+
+		AddBusToStopsIndex(bus_ref);
+
+		AddBusStopIds(bus_ref);
+		answers_ready_ = false;
+		return &bus_ref;
+	}
+
+	void TransportCatalogue::ComputeBusStats(Bus& bus) const
+	{
+		//Находим уникальные остоновки
+		std::vector<Stop*> tmp(bus.stops_.begin(), bus.stops_.end());
+		std::sort(tmp.begin(), tmp.end());
+		auto last = std::unique(tmp.begin(), tmp.end());
+
+		bus.unique_stops_ = std::distance(tmp.begin(), last);
+
+		// Рассчитываем длинну маршрута
+		if (bus.GetRouteStops().size() > 1) {
+			ComputeRouteLength(bus);
+		}
 	}
 
 	void TransportCatalogue::AddBusData(Bus&& bus)
 	{
-		if (routenames_to_routes_.count(bus.bus_name_) == 0) {
+		if (FindRouteByName(bus.bus_name_) == nullptr) {
 			// заполнение основной базы
+			bus.id_ = static_cast<BusId>(routes_data_.size());
+			// имя в пуле и индекс имя -> маршрут для поиска
+			const names::NameId name_id = AddName(bus.bus_name_);
+			bus.bus_name_ = names_pool_.Get(name_id);
+			name_to_bus_[name_id] = bus.id_;
 			auto& ref = routes_data_.emplace_back(std::move(bus));
 			// заполнение базы для роутера
 			_all_buses_to_router.push_back(&ref);
-			// заполнение мапы для ускоренного поиска
-			routenames_to_routes_.insert({ std::string_view(ref.bus_name_), &ref });
 
+			AddBusToStopsIndex(ref);
+			AddBusStopIds(ref);
+			answers_ready_ = false;
 		}
 	}
 
 	void TransportCatalogue::AddStopsDistance(Stop* from_stop, Stop* to_stop, size_t dist)
 	{
 		if (from_stop != nullptr && to_stop != nullptr) {
-			stops_distances_.insert({ {from_stop, to_stop}, dist });
+			stops_distances_.Add(from_stop->id_, to_stop->id_, static_cast<uint32_t>(dist));
 		}
 	}
 
 	void TransportCatalogue::AddRouteFromSerializer(Bus&& bus) {
 		// добавляем если такого маршрута нет в базе
-		if (routenames_to_routes_.count(bus.bus_name_) == 0) {
+		if (FindRouteByName(bus.bus_name_) == nullptr) {
 			// заполнение основной базы
+			bus.id_ = static_cast<BusId>(routes_data_.size());
+			// имя в пуле и индекс имя -> маршрут для поиска
+			const names::NameId name_id = AddName(bus.bus_name_);
+			bus.bus_name_ = names_pool_.Get(name_id);
+			name_to_bus_[name_id] = bus.id_;
 			auto& ref = routes_data_.emplace_back(std::move(bus));
 			// заполнение базы для роутера
 			_all_buses_to_router.push_back(&ref);
-			// заполнение мапы для ускоренного поиска
-			routenames_to_routes_.insert({ std::string_view(ref.bus_name_), &ref });
 
 			// в методе не выполняются математические расчёты расстояний и т.п, так как в базе всё уже есть
+			// индекс остановка -> маршруты тоже восстанавливается из базы через SetBusesForStop
+			AddBusStopIds(ref);
+			answers_ready_ = false;
 		}
 	}
 
-	Stop* TransportCatalogue::FindStopByName(const std::string_view stop) const
+	void TransportCatalogue::SetBusesForStop(const Stop* stop, BusIdsList&& bus_ids)
 	{
-		if (stopnames_to_stops_.count(stop) == 0) {
-			return nullptr;
+		if (stop != nullptr) {
+			stop_buses_index_[stop->id_] = std::move(bus_ids);
+			answers_ready_ = false;
+		}
+	}
+
+	BusIdsList TransportCatalogue::UpdateStopCoordinates(Stop* stop, const geo::Coordinates& coordinates)
+	{
+		if (stop == nullptr) {
+			return {};
+		}
+
+		if (coordinates_quantized_) {
+			const geo::QuantizedCoordinates quantized = geo::Quantize(coordinates);
+			stop->coordinates_ = geo::Dequantize(quantized);
+			stops_quantized_coordinates_[stop->id_] = quantized;
 		}
 		else {
-			return stopnames_to_stops_.at(stop);
+			stop->coordinates_ = coordinates;
+			stops_coordinates_[stop->id_] = coordinates;
+		}
+		stops_trigonometry_.Set(stop->id_, stop->coordinates_);
+		stops_index_ready_ = false;
+
+		const BusIdsList& affected = stop_buses_index_[stop->id_];
+		for (const BusId id : affected) {
+			ComputeRouteLength(*_all_buses_to_router[id]);
 		}
+		answers_ready_ = false;
+		return affected;
 	}
 
-	Bus* TransportCatalogue::FindRouteByName(const std::string_view route) const
+	BusIdsList TransportCatalogue::SetStopsDistance(Stop* from_stop, Stop* to_stop, size_t dist)
+	{
+		if (from_stop == nullptr || to_stop == nullptr) {
+			return {};
+		}
+		stops_distances_.Set(from_stop->id_, to_stop->id_, static_cast<uint32_t>(dist));
+
+		// Расстояние from -> to служит и обратным, если то не задано, поэтому
+		// затронуты все маршруты, проходящие через обе остановки
+		BusIdsList affected;
+		intersection::Intersect(stop_buses_index_[from_stop->id_], stop_buses_index_[to_stop->id_], affected);
+		for (const BusId id : affected) {
+			ComputeRouteLength(*_all_buses_to_router[id]);
+		}
+		answers_ready_ = false;
+		return affected;
+	}
+
+	bool TransportCatalogue::AddStopToBus(Bus* bus, Stop* stop, std::optional<size_t> position)
+	{
+		if (bus == nullptr || stop == nullptr) {
+			return false;
+		}
+
+		// Первая и последняя остановки кольцевого маршрута совпадают и остаются на местах
+		StopsList& stops = bus->stops_;
+		const bool closed = bus->is_circular_ && !stops.empty();
+		const size_t first = closed ? 1U : 0U;
+		const size_t last = closed ? stops.size() - 1 : stops.size();
+		const size_t pos = position.value_or(last);
+		if (pos < first || pos > last) {
+			return false;
+		}
+
+		// Позиция в общем массиве id считается без ненайденных остановок маршрута
+		const size_t csr_pos = buses_stops_offsets_[bus->id_]
+			+ std::count_if(stops.begin(), stops.begin() + pos, [](const Stop* item) { return item != nullptr; });
+		stops.insert(stops.begin() + pos, stop);
+		buses_stops_.insert(buses_stops_.begin() + csr_pos, stop->id_);
+		for (size_t id = bus->id_ + 1; id != buses_stops_offsets_.size(); ++id) {
+			++buses_stops_offsets_[id];
+		}
+
+		BusIdsList& bus_ids = stop_buses_index_[stop->id_];
+		const auto it = std::lower_bound(bus_ids.begin(), bus_ids.end(), bus->id_);
+		if (it == bus_ids.end() || *it != bus->id_) {
+			bus_ids.insert(it, bus->id_);
+		}
+
+		ComputeBusStats(*bus);
+		answers_ready_ = false;
+		return true;
+	}
+
+	void TransportCatalogue::AddBusStopIds(const Bus& bus)
 	{
-		if (routenames_to_routes_.count(route) == 0) {
+		for (const Stop* stop : bus.stops_) {
+			if (stop != nullptr) {
+				buses_stops_.push_back(stop->id_);
+			}
+		}
+		buses_stops_offsets_.push_back(buses_stops_.size());
+	}
+
+	void TransportCatalogue::AddBusToStopsIndex(const Bus& bus)
+	{
+		// id маршрутов выдаются по возрастанию, поэтому списки остаются отсортированными,
+		// а повторный заход маршрута на остановку виден по последнему элементу
+		for (const Stop* stop : bus.stops_) {
+			if (stop == nullptr) {
+				continue;
+			}
+			BusIdsList& bus_ids = stop_buses_index_[stop->id_];
+			if (bus_ids.empty() || bus_ids.back() != bus.id_) {
+				bus_ids.push_back(bus.id_);
+			}
+		}
+	}
+
+	Stop* TransportCatalogue::FindStopByName(const std::string_view stop) const
+	{
+		const auto name_id = names_pool_.Find(stop);
+		if (!name_id || name_to_stop_[*name_id] == NO_ID) {
 			return nullptr;
 		}
-		else {
-			return routenames_to_routes_.at(route);
+		return _all_stops_to_router[name_to_stop_[*name_id]];
+	}
+
+	Bus* TransportCatalogue::FindRouteByName(const std::string_view route) const
+	{
+		const auto name_id = names_pool_.Find(route);
+		if (!name_id || name_to_bus_[*name_id] == NO_ID) {
+			return nullptr;
 		}
+		return _all_buses_to_router[name_to_bus_[*name_id]];
 	}
 
-	BusStat* TransportCatalogue::GetBusInfo(const std::string_view route) const
+	const BusStat* TransportCatalogue::GetBusInfo(const std::string_view route) const
 	{
-		Bus* bus_ref = FindRouteByName(route);
+		const Bus* bus_ref = FindRouteByName(route);
 		if (bus_ref == nullptr) {
 			return nullptr;
 		}
-		return new BusStat(bus_ref->bus_name_, bus_ref->stops_.size(), bus_ref->unique_stops_,
-			bus_ref->real_route_length_, bus_ref->route_curvature_);
+		if (!answers_ready_) {
+			throw std::logic_error("Answers are not built");
+		}
+		return &buses_answers_[bus_ref->id_];
 	}
 
-	StopStat* TransportCatalogue::GetBusesForStopInfo(const std::string_view bus_stop) const
+	const StopStat* TransportCatalogue::GetBusesForStopInfo(const std::string_view bus_stop) const
 	{
-		Stop* stop = FindStopByName(bus_stop);
+		const Stop* stop = FindStopByName(bus_stop);
 		if (stop == nullptr) return nullptr;
-		std::set<std::string_view> buses;
-		for (const auto& route : routenames_to_routes_) {
-			auto tmp = std::find_if(route.second->stops_.begin(), route.second->stops_.end(),
-				[bus_stop](Stop* curr_stop) {
-					return (curr_stop->name_ == bus_stop);
-				});
-			if (tmp != route.second->stops_.end()) {
-				buses.insert(route.second->bus_name_);
+		if (!answers_ready_) {
+			throw std::logic_error("Answers are not built");
+		}
+		return &stops_answers_[stop->id_];
+	}
+
+	void TransportCatalogue::BuildAnswers()
+	{
+		if (answers_ready_) {
+			return;
+		}
+
+		buses_answers_.clear();
+		buses_answers_.reserve(routes_data_.size());
+		for (const Bus& bus : routes_data_) {
+			buses_answers_.emplace_back(bus.bus_name_, bus.GetRouteStops().size(), bus.unique_stops_,
+				bus.real_route_length_, bus.route_curvature_);
+		}
+
+		// Сначала все имена подряд: указатели в записи берутся после того,
+		// как массив перестал расти
+		stops_answers_buses_.clear();
+		std::vector<size_t> offsets = { 0U };
+		offsets.reserve(stops_data_.size() + 1);
+		for (const BusIdsList& bus_ids : stop_buses_index_) {
+			const size_t first = stops_answers_buses_.size();
+			for (const BusId id : bus_ids) {
+				stops_answers_buses_.push_back(_all_buses_to_router[id]->bus_name_);
 			}
+			std::sort(stops_answers_buses_.begin() + first, stops_answers_buses_.end());
+			offsets.push_back(stops_answers_buses_.size());
 		}
-		return  new StopStat(bus_stop, buses);
+
+		stops_answers_.clear();
+		stops_answers_.reserve(stops_data_.size());
+		const std::string_view* names = stops_answers_buses_.data();
+		for (const Stop& stop : stops_data_) {
+			stops_answers_.push_back({ stop.name_, { names + offsets[stop.id_], names + offsets[stop.id_ + 1] } });
+		}
+
+		answers_ready_ = true;
 	}
 
-	const BusesMap& TransportCatalogue::GetBusesMap() const
+	const BusIdsList& TransportCatalogue::GetBusIdsForStop(const Stop* stop) const
 	{
-		return routenames_to_routes_;
+		return stop_buses_index_.at(stop->id_);
 	}
 
-	const StopsMap& TransportCatalogue::GetStopsMap()  const
+	ConnectionStat TransportCatalogue::GetDirectConnections(const std::string_view from, const std::string_view to) const
 	{
-		return stopnames_to_stops_;
+		ConnectionStat result;
+		const Stop* from_stop = FindStopByName(from);
+		const Stop* to_stop = FindStopByName(to);
+		if (from_stop == nullptr || to_stop == nullptr) {
+			return result;
+		}
+		result.is_found_ = true;
+
+		BusIdsList common_buses;
+		intersection::Intersect(stop_buses_index_[from_stop->id_], stop_buses_index_[to_stop->id_], common_buses);
+
+		for (const BusId id : common_buses) {
+			const Bus* bus = _all_buses_to_router[id];
+			if (from_stop == to_stop) {
+				result.connections_.push_back({ bus->bus_name_, 0, 0U });
+				continue;
+			}
+
+			// Ищем кратчайший отрезок from -> to по ходу движения маршрута
+			const auto stops = bus->GetRouteStops();
+			std::optional<size_t> last_from;
+			std::optional<std::pair<size_t, size_t>> best;
+			for (size_t i = 0; i != stops.size(); ++i) {
+				if (stops[i] == from_stop) {
+					last_from = i;
+				}
+				else if (stops[i] == to_stop && last_from
+					&& (!best || i - *last_from < best->second - best->first)) {
+					best = { *last_from, i };
+				}
+			}
+			if (!best) {
+				continue;
+			}
+
+			size_t route_length = 0U;
+			for (size_t i = best->first + 1; i <= best->second; ++i) {
+				route_length += GetDistance(stops[i - 1], stops[i]);
+			}
+			result.connections_.push_back({ bus->bus_name_,
+				static_cast<int>(best->second - best->first), route_length });
+		}
+
+		std::sort(result.connections_.begin(), result.connections_.end(),
+			[](const ConnectionItem& lhs, const ConnectionItem& rhs) {
+				return lhs.bus_name_ < rhs.bus_name_;
+			});
+		return result;
+	}
+
+	Bus* TransportCatalogue::GetBusById(BusId id) const
+	{
+		return _all_buses_to_router.at(id);
+	}
+
+	size_t TransportCatalogue::GetStopBusesIndexMemory() const
+	{
+		size_t result = stop_buses_index_.capacity() * sizeof(BusIdsList);
+		for (const BusIdsList& bus_ids : stop_buses_index_) {
+			result += bus_ids.capacity() * sizeof(BusId);
+		}
+		return result;
 	}
 
-	const TransportCatalogue::MapStopsDistances& TransportCatalogue::GetStopDistancesRef() const
+	const distances::DistanceTable& TransportCatalogue::GetStopDistancesRef() const
 	{
 		return stops_distances_;
 	}
 
 	size_t TransportCatalogue::GetDistanceBase(Stop* from_stop, Stop* to_stop) const
 	{
-		if (stops_distances_.count({ from_stop, to_stop }) > 0) {
-			return stops_distances_.at({ from_stop, to_stop });
-		}
-		else {
-			return 0U;
-		}
+		return stops_distances_.GetDirected(from_stop->id_, to_stop->id_);
 	}
 
-	size_t TransportCatalogue::GetDistance(Stop* from_stop, Stop* to_stop) const
+	size_t TransportCatalogue::GetDistance(const Stop* from_stop, const Stop* to_stop) const
 	{
-		size_t result = GetDistanceBase(from_stop, to_stop);
+		return GetDistance(from_stop->id_, to_stop->id_);
+	}
 
-		return (result > 0 ? result : GetDistanceBase(to_stop, from_stop));
+	size_t TransportCatalogue::GetDistance(StopId from_stop, StopId to_stop) const
+	{
+		// прямое и обратное направления хранятся в одной ячейке - достаточно одной пробы
+		return stops_distances_.Get(from_stop, to_stop);
 	}
 
 	size_t TransportCatalogue::GetStopsCount() const
@@ -190,6 +538,192 @@ namespace transport_catalogue {
 		return stops_data_.size();
 	}
 
+	size_t TransportCatalogue::GetBusesCount() const
+	{
+		return routes_data_.size();
+	}
+
+	Stop* TransportCatalogue::GetStopById(StopId id) const
+	{
+		return _all_stops_to_router.at(id);
+	}
+
+	std::string_view TransportCatalogue::GetStopName(StopId id) const
+	{
+		return stops_names_[id];
+	}
+
+	geo::Coordinates TransportCatalogue::GetStopCoordinates(StopId id) const
+	{
+		return coordinates_quantized_ ? geo::Dequantize(stops_quantized_coordinates_[id]) : stops_coordinates_[id];
+	}
+
+	void TransportCatalogue::SetCoordinatesQuantization(bool quantized)
+	{
+		coordinates_quantized_ = quantized;
+	}
+
+	bool TransportCatalogue::IsCoordinatesQuantized() const
+	{
+		return coordinates_quantized_;
+	}
+
+	const geo::QuantizedCoordinates& TransportCatalogue::GetStopQuantizedCoordinates(StopId id) const
+	{
+		return stops_quantized_coordinates_[id];
+	}
+
+	TransportCatalogue::StopIdsRange TransportCatalogue::GetBusStopIds(BusId id) const
+	{
+		return { buses_stops_.begin() + buses_stops_offsets_[id], buses_stops_.begin() + buses_stops_offsets_[id + 1],
+			_all_buses_to_router[id]->is_circular_ };
+	}
+
+	NearbyStopsStat TransportCatalogue::GetNearestStops(const geo::Coordinates& point, size_t count) const
+	{
+		if (!stops_index_ready_) {
+			throw std::logic_error("Stops index is not built");
+		}
+		return MakeNearbyStops(stops_index_.Nearest(point, count));
+	}
+
+	NearbyStopsStat TransportCatalogue::GetStopsInRadius(const geo::Coordinates& point, double radius) const
+	{
+		if (!stops_index_ready_) {
+			throw std::logic_error("Stops index is not built");
+		}
+		return MakeNearbyStops(stops_index_.InRadius(point, radius));
+	}
+
+	NearbyStopsStat TransportCatalogue::GetStopsInBox(const geo::Coordinates& min, const geo::Coordinates& max) const
+	{
+		if (!stops_index_ready_) {
+			throw std::logic_error("Stops index is not built");
+		}
+		return MakeNearbyStops(stops_index_.InBox(min, max));
+	}
+
+	void TransportCatalogue::BuildStopsIndex()
+	{
+		if (!stops_index_ready_) {
+			stops_index_.Build(GetAllStopsCoordinates());
+			stops_index_ready_ = true;
+		}
+	}
+
+	bool TransportCatalogue::RestoreStopsIndex(std::vector<StopId>&& order)
+	{
+		stops_index_ready_ = stops_index_.Restore(std::move(order), GetAllStopsCoordinates());
+		return stops_index_ready_;
+	}
+
+	const spatial::SpatialIndex& TransportCatalogue::GetStopsIndex() const
+	{
+		if (!stops_index_ready_) {
+			throw std::logic_error("Stops index is not built");
+		}
+		return stops_index_;
+	}
+
+	StopSearchStat TransportCatalogue::SearchStops(std::string_view prefix, size_t limit, size_t max_edits) const
+	{
+		if (!stop_names_index_ready_) {
+			throw std::logic_error("Stop names index is not built");
+		}
+		std::vector<search::Match> matches = stop_names_index_.FindFuzzyPrefix(prefix, max_edits);
+
+		const auto better = [this](const search::Match& lhs, const search::Match& rhs) {
+			const size_t lhs_buses = stop_buses_index_[lhs.id].size();
+			const size_t rhs_buses = stop_buses_index_[rhs.id].size();
+			if (lhs.edits != rhs.edits) {
+				return lhs.edits < rhs.edits;
+			}
+			if (lhs_buses != rhs_buses) {
+				return lhs_buses > rhs_buses;
+			}
+			return stops_names_[lhs.id] < stops_names_[rhs.id];
+		};
+		limit = std::min(limit, matches.size());
+		std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+
+		StopSearchStat result;
+		result.reserve(limit);
+		for (size_t i = 0; i != limit; ++i) {
+			result.push_back({ stops_names_[matches[i].id], stop_buses_index_[matches[i].id].size() });
+		}
+		return result;
+	}
+
+	void TransportCatalogue::BuildStopNamesIndex()
+	{
+		if (!stop_names_index_ready_) {
+			stop_names_index_.Build(stops_names_);
+			stop_names_index_ready_ = true;
+		}
+	}
+
+	bool TransportCatalogue::RestoreStopNamesIndex(std::vector<StopId>&& order)
+	{
+		stop_names_index_ready_ = stop_names_index_.Restore(std::move(order), stops_names_);
+		return stop_names_index_ready_;
+	}
+
+	const search::NameIndex& TransportCatalogue::GetStopNamesIndex() const
+	{
+		if (!stop_names_index_ready_) {
+			throw std::logic_error("Stop names index is not built");
+		}
+		return stop_names_index_;
+	}
+
+	std::vector<geo::Coordinates> TransportCatalogue::GetAllStopsCoordinates() const
+	{
+		std::vector<geo::Coordinates> coordinates;
+		coordinates.reserve(stops_data_.size());
+		for (StopId id = 0; id != stops_data_.size(); ++id) {
+			coordinates.push_back(GetStopCoordinates(id));
+		}
+		return coordinates;
+	}
+
+	NearbyStopsStat TransportCatalogue::MakeNearbyStops(const std::vector<spatial::Neighbor>& neighbors) const
+	{
+		NearbyStopsStat result;
+		result.reserve(neighbors.size());
+		for (const spatial::Neighbor& neighbor : neighbors) {
+			result.push_back({ stops_names_[neighbor.id], neighbor.distance });
+		}
+		return result;
+	}
+
+	names::NameId TransportCatalogue::AddName(std::string_view name)
+	{
+		const names::NameId name_id = names_pool_.Intern(name);
+		if (name_id >= name_to_stop_.size()) {
+			name_to_stop_.resize(names_pool_.size(), NO_ID);
+			name_to_bus_.resize(names_pool_.size(), NO_ID);
+		}
+		return name_id;
+	}
+
+	void TransportCatalogue::BuildNameIndex()
+	{
+		names_pool_.BuildPerfectHash();
+	}
+
+	void TransportCatalogue::RestoreNames(const std::vector<std::string_view>& names,
+		perfect_hash::MinimalPerfectHash&& hash)
+	{
+		names_pool_.Restore(names, std::move(hash));
+		name_to_stop_.assign(names_pool_.size(), NO_ID);
+		name_to_bus_.assign(names_pool_.size(), NO_ID);
+	}
+
+	const names::StringPool& TransportCatalogue::GetNamesPool() const
+	{
+		return names_pool_;
+	}
+
 	const std::deque<Stop*>& TransportCatalogue::GetAllStopsData() const
 	{
 		return _all_stops_to_router;
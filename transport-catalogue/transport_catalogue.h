@@ -2,6 +2,7 @@
 
 #include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -9,8 +10,18 @@
 #include <algorithm>
 #include <set>
 #include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <future>
+#include <thread>
 
+#include "distance_table.h"
 #include "domain.h"
+#include "intersection.h"
+#include "name_index.h"
+#include "ranges.h"
+#include "spatial_index.h"
+#include "string_pool.h"
 
 namespace transport_catalogue {
 
@@ -21,39 +32,157 @@ namespace transport_catalogue {
 
 		TransportCatalogue() = default;
 
-		using MapStopsDistances = std::unordered_map<std::pair<Stop*, Stop*>, size_t, PointersPairHasher>;
+		// Имена остановок и маршрутов ссылаются на пул строк каталога, копировать его нельзя
+		TransportCatalogue(const TransportCatalogue&) = delete;
+		TransportCatalogue& operator=(const TransportCatalogue&) = delete;
 
-		void ComputeRouteLength(Bus& route);
+		// Копия со своим пулом строк: имена, id и указатели копии ссылаются только на неё.
+		// Из неё писатель готовит следующую версию, пока читатели работают с этой
+		std::unique_ptr<TransportCatalogue> Clone() const;
+
+		// Остановки маршрута хранятся один раз, обратный ход некольцевого маршрута даёт представление
+		using StopIdsRange = ranges::RouteRange<std::vector<StopId>::const_iterator>;
+
+		void ComputeRouteLength(Bus& route) const;
 		void AddStop(Stop&& stop);
 		void AddBus(Bus&& route);
+		// Меньше маршрутов на задачу не окупают запуск потока
+		static constexpr size_t MIN_BUSES_PER_TASK = 256U;
+
+		// Пакетное добавление: статистика маршрутов считается параллельно после вставки всех маршрутов,
+		// не более чем в threads потоков; 0 - по числу ядер
+		void AddBuses(std::vector<Bus>&& buses, size_t threads = 0U);
 		void AddBusData(Bus&& bus);
 		void AddStopsDistance(Stop* from_stop, Stop* to_stop, size_t dist);
 		void AddRouteFromSerializer(Bus&& bus);
+		void SetBusesForStop(const Stop* stop, BusIdsList&& bus_ids);
+
+		// Изменения загруженного каталога. Пересчитываются только маршруты через изменённые
+		// остановки; возвращаются id маршрутов, у которых пересчитаны длины
+		BusIdsList UpdateStopCoordinates(Stop* stop, const geo::Coordinates& coordinates);
+		BusIdsList SetStopsDistance(Stop* from_stop, Stop* to_stop, size_t dist);
+		// Вставляет остановку перед position-й из хранимых остановок маршрута, по умолчанию в конец
+		// (у кольцевого - перед замыкающей). false - позиция вне маршрута, маршрут не изменён
+		bool AddStopToBus(Bus* bus, Stop* stop, std::optional<size_t> position);
 
 		Stop* FindStopByName(const std::string_view stop) const;
 		Bus* FindRouteByName(const std::string_view route) const;
-		BusStat* GetBusInfo(const std::string_view route) const;
-		StopStat* GetBusesForStopInfo(const std::string_view bus_stop) const;
-		const BusesMap& GetBusesMap() const;
-		const StopsMap& GetStopsMap() const;
-		const MapStopsDistances& GetStopDistancesRef() const;
+		// Ответы на запросы Bus и Stop считаются один раз для всех маршрутов и остановок
+		// и отдаются указателем на хранимую запись; nullptr - объект не найден.
+		// std::logic_error, если после изменения каталога ответы не построены заново
+		const BusStat* GetBusInfo(const std::string_view route) const;
+		const StopStat* GetBusesForStopInfo(const std::string_view bus_stop) const;
+		// Готовые ответы строятся отдельным шагом перед публикацией каталога читателям:
+		// константные методы каталог не меняют, и читать его можно из нескольких потоков
+		void BuildAnswers();
+		const BusIdsList& GetBusIdsForStop(const Stop* stop) const;
+		ConnectionStat GetDirectConnections(const std::string_view from, const std::string_view to) const;
+
+		// Поиск остановок по координатам через пространственный индекс.
+		// Индекс строится перед сериализацией и публикацией каталога, при загрузке восстанавливается из базы.
+		// Добавление и перемещение остановок сбрасывают его: до нового BuildStopsIndex поиск и GetStopsIndex бросают std::logic_error
+		NearbyStopsStat GetNearestStops(const geo::Coordinates& point, size_t count) const;
+		NearbyStopsStat GetStopsInRadius(const geo::Coordinates& point, double radius) const;
+		NearbyStopsStat GetStopsInBox(const geo::Coordinates& min, const geo::Coordinates& max) const;
+		void BuildStopsIndex();
+		bool RestoreStopsIndex(std::vector<StopId>&& order);
+		const spatial::SpatialIndex& GetStopsIndex() const;
+
+		// Поиск остановок по началу имени, при max_edits > 0 - с опечатками. Возвращается до limit
+		// остановок: сначала с меньшим числом правок, затем обслуживаемые большим числом маршрутов.
+		// Индекс имён, как и пространственный, сбрасывается при добавлении остановок: до BuildStopNamesIndex
+		// поиск и GetStopNamesIndex бросают std::logic_error
+		StopSearchStat SearchStops(std::string_view prefix, size_t limit, size_t max_edits) const;
+		void BuildStopNamesIndex();
+		bool RestoreStopNamesIndex(std::vector<StopId>&& order);
+		const search::NameIndex& GetStopNamesIndex() const;
+		Bus* GetBusById(BusId id) const;
+		size_t GetStopBusesIndexMemory() const;
+		const distances::DistanceTable& GetStopDistancesRef() const;
 		size_t GetDistanceBase(Stop* from_stop, Stop* to_stop) const;
-		size_t GetDistance(Stop* from_stop, Stop* to_stop) const;
+		size_t GetDistance(const Stop* from_stop, const Stop* to_stop) const;
+		size_t GetDistance(StopId from_stop, StopId to_stop) const;
 		size_t GetStopsCount() const;
+		size_t GetBusesCount() const;
+
+		// Доступ к плотным массивам по id остановок и маршрутов
+		Stop* GetStopById(StopId id) const;
+		std::string_view GetStopName(StopId id) const;
+		geo::Coordinates GetStopCoordinates(StopId id) const;
+
+		// Режим хранения координат в микроградусах. Включается до добавления остановок:
+		// координаты остановок округляются к сетке, а массив координат хранит int32
+		void SetCoordinatesQuantization(bool quantized);
+		bool IsCoordinatesQuantized() const;
+		const geo::QuantizedCoordinates& GetStopQuantizedCoordinates(StopId id) const;
+		StopIdsRange GetBusStopIds(BusId id) const;
+
+		// Пул имён остановок и маршрутов
+		const names::StringPool& GetNamesPool() const;
+		// Совершенная хеш-функция над именами строится при создании базы и сохраняется в неё,
+		// при загрузке имена восстанавливаются вместе с ней без построения хеш-таблиц
+		void BuildNameIndex();
+		void RestoreNames(const std::vector<std::string_view>& names, perfect_hash::MinimalPerfectHash&& hash);
 		
 		const std::deque<Stop*>& GetAllStopsData() const;
 		const std::deque<Bus*>& GetAllBusesData() const;
 	private:
 
+		Bus* InsertBus(Bus&& bus);
+		void ComputeBusStats(Bus& bus) const;
+		void AddBusToStopsIndex(const Bus& bus);
+		void AddBusStopIds(const Bus& bus);
+		names::NameId AddName(std::string_view name);
+		std::vector<geo::Coordinates> GetAllStopsCoordinates() const;
+		NearbyStopsStat MakeNearbyStops(const std::vector<spatial::Neighbor>& neighbors) const;
+
+		static constexpr uint32_t NO_ID = UINT32_MAX;
+
+		// Объявлен первым: имена в остальных контейнерах ссылаются на него
+		names::StringPool names_pool_;
+
 		std::deque<Stop> stops_data_;
 		std::deque<Stop*> _all_stops_to_router;
-		StopsMap stopnames_to_stops_;
+		// id остановки по id её имени, NO_ID если остановки с таким именем нет
+		std::vector<StopId> name_to_stop_;
 
 		std::deque<Bus> routes_data_;
 		std::deque<Bus*> _all_buses_to_router;
-		BusesMap routenames_to_routes_;
+		std::vector<BusId> name_to_bus_;
+
+		// Дорожные расстояния по парам id остановок
+		distances::DistanceTable stops_distances_;
+
+		// Инвертированный индекс остановка -> маршруты, индексируется Stop::id_
+		std::vector<BusIdsList> stop_buses_index_;
+
+		// Данные остановок по Stop::id_ в непрерывных массивах.
+		// Заполняется один из массивов координат в зависимости от режима
+		bool coordinates_quantized_ = false;
+		std::vector<geo::Coordinates> stops_coordinates_;
+		std::vector<geo::QuantizedCoordinates> stops_quantized_coordinates_;
+		std::vector<std::string_view> stops_names_;
+		// Координаты остановок с синусом и косинусом широты для расстояний по прямой
+		geo::TrigonometricTable stops_trigonometry_;
+
+		// k-d дерево координат остановок; сбрасывается при добавлении и перемещении остановок
+		spatial::SpatialIndex stops_index_;
+		bool stops_index_ready_ = false;
+
+		// Отсортированные имена остановок для поиска по префиксу; сбрасывается при добавлении остановок
+		search::NameIndex stop_names_index_;
+		bool stop_names_index_ready_ = false;
+
+		// Остановки всех маршрутов подряд: маршрут id занимает
+		// [buses_stops_offsets_[id], buses_stops_offsets_[id + 1])
+		std::vector<StopId> buses_stops_;
+		std::vector<size_t> buses_stops_offsets_ = { 0U };
 
-		MapStopsDistances stops_distances_;
+		// Готовые ответы по id маршрутов и остановок; сбрасываются при изменении каталога
+		bool answers_ready_ = false;
+		std::vector<BusStat> buses_answers_;
+		std::vector<StopStat> stops_answers_;
+		std::vector<std::string_view> stops_answers_buses_;
 
 	};
 } // namespace transport_catalogue
\ No newline at end of file
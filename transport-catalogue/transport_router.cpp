@@ -16,6 +16,10 @@ namespace transport_catalogue {
 			_bus_velocity = velocity;
 			return *this;
 		}
+		RouterSettings& RouterSettings::SetHugePagePolicy(memory::HugePagePolicy policy) {
+			_huge_page_policy = policy;
+			return *this;
+		}
 
 		size_t RouterSettings::GetBusWaitTime() const {
 			return _bus_wait_time;
@@ -23,17 +27,39 @@ namespace transport_catalogue {
 		double RouterSettings::GetBusVelocity() const {
 			return _bus_velocity;
 		}
+		memory::HugePagePolicy RouterSettings::GetHugePagePolicy() const {
+			return _huge_page_policy;
+		}
+		RouterSettings& RouterSettings::SetWalkingRadius(double radius) {
+			_walking_radius = radius;
+			return *this;
+		}
+		RouterSettings& RouterSettings::SetWalkingVelocity(double velocity) {
+			_walking_velocity = velocity;
+			return *this;
+		}
+		double RouterSettings::GetWalkingRadius() const {
+			return _walking_radius;
+		}
+		double RouterSettings::GetWalkingVelocity() const {
+			return _walking_velocity;
+		}
+		bool RouterSettings::IsWalkingEnabled() const {
+			return _walking_radius > 0.0 && _walking_velocity > 0.0;
+		}
 
-		TransportRouter::TransportRouter(transport_catalogue::TransportCatalogue& tc)
-			: transport_catalogue_(tc), graphs_(tc.GetStopsCount() * 2) {
+		TransportRouter::TransportRouter(const transport_catalogue::TransportCatalogue& tc, std::pmr::memory_resource* resource)
+			: transport_catalogue_(tc), graphs_(tc.GetStopsCount() * 2, resource) {
 		}
 
-		TransportRouter::TransportRouter(transport_catalogue::TransportCatalogue& tc, const RouterSettings& settings)
-			: transport_catalogue_(tc), _settings(settings), graphs_(tc.GetStopsCount() * 2) {
+		TransportRouter::TransportRouter(const transport_catalogue::TransportCatalogue& tc, const RouterSettings& settings
+			, std::pmr::memory_resource* resource)
+			: transport_catalogue_(tc), _settings(settings), graphs_(tc.GetStopsCount() * 2, resource) {
 		}
 
-		TransportRouter::TransportRouter(transport_catalogue::TransportCatalogue& tc, RouterSettings&& settings)
-			: transport_catalogue_(tc), _settings(std::move(settings)), graphs_(tc.GetStopsCount() * 2) {
+		TransportRouter::TransportRouter(const transport_catalogue::TransportCatalogue& tc, RouterSettings&& settings
+			, std::pmr::memory_resource* resource)
+			: transport_catalogue_(tc), _settings(std::move(settings)), graphs_(tc.GetStopsCount() * 2, resource) {
 		}
 
 		TransportRouter& TransportRouter::SetRouterSettings(const RouterSettings& settings) {
@@ -46,13 +72,15 @@ namespace transport_catalogue {
 			return *this;
 		}
 
-		TransportRouter& TransportRouter::SetRouterTransportCatalogue(transport_catalogue::TransportCatalogue& tc) {
-			transport_catalogue_ = tc;
-			return *this;
-		}
-
 		TransportRouter& TransportRouter::SetRouterGraphs(graph::DirectedWeightedGraph<double>&& graphs) {
 			graphs_ = std::move(graphs);
+			_walk_edge_count = 0U;
+			for (graph::EdgeId edge = 0; edge != graphs_.GetEdgeCount(); ++edge) {
+				if (graphs_.GetEdge(edge).GetEdgeType() == graph::EdgeType::walk) {
+					++_walk_edge_count;
+				}
+			}
+			_graph_ready.store(true, std::memory_order_release);
 			return *this;
 		}
 
@@ -79,29 +107,51 @@ namespace transport_catalogue {
 		}
 
 		transport_catalogue::RouteStat TransportRouter::MakeRoute(std::string_view from, std::string_view to) {
-			if (!_router) {
-				ImportRoutingDataFromCatalogue();
+			std::call_once(_router_built, &TransportRouter::BuildRouter, this);
+
+			if (wait_points_.count(from) && move_points_.count(to))
+			{
+				return MakeRouteStat(_router.get()->BuildRoute(
+					wait_points_.at(from), move_points_.at(to)));
+			}
+			return {};
+		}
+
+		transport_catalogue::RouteStat TransportRouter::MakeRouteToAny(std::string_view from,
+			const std::vector<std::string_view>& to_any) {
+			std::call_once(_router_built, &TransportRouter::BuildRouter, this);
+
+			if (!wait_points_.count(from)) {
+				return {};
+			}
+
+			std::vector<graph::VertexId> targets;
+			targets.reserve(to_any.size());
+			for (std::string_view to : to_any) {
+				if (auto it = move_points_.find(to); it != move_points_.end()) {
+					targets.push_back(it->second);
+				}
 			}
 
+			return MakeRouteStat(_router.get()->BuildRouteToAny(wait_points_.at(from), targets));
+		}
+
+		transport_catalogue::RouteStat TransportRouter::MakeRouteStat(
+			const std::optional<graph::Router<double>::RouteInfo>& data) const {
+
 			transport_catalogue::RouteStat result;
-			if (wait_points_.count(from) && move_points_.count(to))
+			if (data.has_value())
 			{
-				auto data = _router.get()->BuildRoute(
-					wait_points_.at(from), move_points_.at(to));
-
-				if (data.has_value())    
-				{
-					result.is_found_ = true;
-					for (auto& item_id : data.value().edges) {
-						const auto& edge = graphs_.GetEdge(item_id);
-						result.route_items_.push_back(transport_catalogue::RouteItem()
-							.SetName(edge.GetEdgeName())
-							.SetEdgeType(edge.GetEdgeType())
-							.SetTime(edge.GetEdgeWeight())
-							.SetSpanCount(edge.GetEdgeSpanCount()));
-
-						result.total_time_ += edge.weight;
-					}
+				result.is_found_ = true;
+				for (auto& item_id : data.value().edges) {
+					const auto& edge = graphs_.GetEdge(item_id);
+					result.route_items_.push_back(transport_catalogue::RouteItem()
+						.SetName(edge.GetEdgeName())
+						.SetEdgeType(edge.GetEdgeType())
+						.SetTime(edge.GetEdgeWeight())
+						.SetSpanCount(edge.GetEdgeSpanCount()));
+
+					result.total_time_ += edge.weight;
 				}
 			}
 			return result;
@@ -109,54 +159,210 @@ namespace transport_catalogue {
 
 		TransportRouter& TransportRouter::ImportRoutingDataFromCatalogue() {
 
-			size_t points_counter = 0;
-			for (const auto& stop : transport_catalogue_.GetAllStopsData()) {
+			ImportGraph();
 
-				wait_points_.insert({ stop->name_, points_counter });
-				move_points_.insert({ stop->name_, ++points_counter });
+			_router = std::make_unique<graph::Router<double>>(graphs_, _settings.GetHugePagePolicy());
+			return *this;
+		}
+
+		TransportRouter& TransportRouter::ImportRoutingDataFromPrevious(const TransportRouter& previous,
+			const std::vector<bool>& changed_buses) {
+
+			const TransportCatalogue& previous_catalogue = previous.transport_catalogue_;
+			const StopId stops_count = static_cast<StopId>(transport_catalogue_.GetStopsCount());
+			const BusId buses_count = static_cast<BusId>(transport_catalogue_.GetBusesCount());
+
+			// и   :       
+			const auto previous_edges = [&previous_catalogue](BusId id) {
+				const size_t stops = previous_catalogue.GetBusStopIds(id).size();
+				return stops > 1 ? stops * (stops - 1) / 2 : 0U;
+			};
+
+			bool reusable = previous._graph_ready.load(std::memory_order_acquire)
+				&& previous._settings.GetBusWaitTime() == _settings.GetBusWaitTime()
+				&& previous._settings.GetBusVelocity() == _settings.GetBusVelocity()
+				&& previous_catalogue.GetStopsCount() == stops_count
+				&& previous_catalogue.GetBusesCount() == buses_count
+				&& changed_buses.size() == buses_count;
+			if (reusable) {
+				size_t edge_count = stops_count;
+				for (BusId id = 0; id != buses_count; ++id) {
+					edge_count += previous_edges(id);
+				}
+				reusable = edge_count + previous._walk_edge_count == previous.graphs_.GetEdgeCount();
+			}
+			if (!reusable) {
+				ImportGraph();
+				return *this;
+			}
+
+			ReserveGraph();
+			ImportStops();
+
+			graph::EdgeId previous_edge = stops_count;
+			for (BusId id = 0; id != buses_count; ++id) {
+				const size_t edges = previous_edges(id);
+				if (changed_buses[id]) {
+					BuidEdgeTask(id, id + 1);
+				}
+				else {
+					//   -     
+					const std::string_view bus_name = transport_catalogue_.GetBusById(id)->bus_name_;
+					for (graph::EdgeId edge = previous_edge; edge != previous_edge + edges; ++edge) {
+						graphs_.AddEdge(graph::Edge<double>(previous.graphs_.GetEdge(edge)).SetEdgeName(bus_name));
+					}
+				}
+				previous_edge += edges;
+			}
+			//         
+			ImportWalkEdges();
+
+			_graph_ready.store(true, std::memory_order_release);
+			return *this;
+		}
+
+		void TransportRouter::EnsureGraph() {
+			std::call_once(_graph_built, [this] {
+				if (!_graph_ready.load(std::memory_order_acquire)) {
+					ImportGraph();
+				}
+			});
+		}
+
+		void TransportRouter::ImportGraph() {
+
+			ReserveGraph();
+			ImportStops();
+			BuidEdgeTask(0, static_cast<BusId>(transport_catalogue_.GetBusesCount()));
+			ImportWalkEdges();
+
+			_graph_ready.store(true, std::memory_order_release);
+		}
+
+		void TransportRouter::ImportStops() {
+
+			const StopId stops_count = static_cast<StopId>(transport_catalogue_.GetStopsCount());
+			for (StopId id = 0; id != stops_count; ++id) {
+
+				const std::string_view stop_name = transport_catalogue_.GetStopName(id);
+				wait_points_.insert({ stop_name, GetWaitVertex(id) });
+				move_points_.insert({ stop_name, GetMoveVertex(id) });
 
 				graphs_.AddEdge(graph::Edge<double>()
 					.SetEdgeType(graph::EdgeType::wait)
-					.SetVertexFromId(wait_points_.at(stop->name_))
-					.SetVertexToId(move_points_.at(stop->name_))
+					.SetVertexFromId(GetWaitVertex(id))
+					.SetVertexToId(GetMoveVertex(id))
 					.SetEdgeWeight(static_cast<double>(_settings.GetBusWaitTime()))
-					.SetEdgeName(stop->name_)
+					.SetEdgeName(stop_name)
 					.SetEdgeSpanCount(0));
-				++points_counter;
 			}
+		}
+
+		void TransportRouter::BuidEdgeTask(BusId first, BusId last) {
+
+			for (; first != last; ++first) {
 
-			for (const auto& bus : transport_catalogue_.GetAllBusesData()) {
+				const auto stops = transport_catalogue_.GetBusStopIds(first);
+				const std::string_view bus_name = transport_catalogue_.GetBusById(first)->bus_name_;
 
 				//      
-				for (size_t from_stop_id = 0; from_stop_id != bus->stops_.size(); ++from_stop_id) {
+				for (size_t from_stop_id = 0; from_stop_id != stops.size(); ++from_stop_id) {
 
 					int span_count = 0;
+					double route_distance = 0.0;
 
-					//     
-					for (size_t to_stop_id = from_stop_id + 1; to_stop_id != bus->stops_.size(); ++to_stop_id) {
+					//     ,    
+					for (size_t to_stop_id = from_stop_id + 1; to_stop_id != stops.size(); ++to_stop_id) {
 
-						double route_distance = 0.0;
-
-						//      
-						for (size_t current_point = from_stop_id + 1; current_point <= to_stop_id; ++current_point) {
-							route_distance += static_cast<double>(transport_catalogue_
-								.GetDistance(bus->stops_[current_point - 1], bus->stops_[current_point]));
-						}
+						route_distance += static_cast<double>(transport_catalogue_
+							.GetDistance(stops[to_stop_id - 1], stops[to_stop_id]));
 
 						graphs_.AddEdge(graph::Edge<double>()
 							.SetEdgeType(graph::EdgeType::move)
-							.SetVertexFromId(move_points_.at(bus->stops_[from_stop_id]->name_))
-							.SetVertexToId(wait_points_.at(bus->stops_[to_stop_id]->name_))
+							.SetVertexFromId(GetMoveVertex(stops[from_stop_id]))
+							.SetVertexToId(GetWaitVertex(stops[to_stop_id]))
 							.SetEdgeWeight(route_distance / (_settings.GetBusVelocity() * VELOCITY_COEF))
-							.SetEdgeName(bus->bus_name_)
+							.SetEdgeName(bus_name)
 							.SetEdgeSpanCount(++span_count));
 					}
 
 				}
 
 			}
-			_router = std::make_unique<graph::Router<double>>(graphs_);
-			return *this;
+		}
+
+		void TransportRouter::ImportWalkEdges() {
+
+			const double velocity = _settings.GetWalkingVelocity() * VELOCITY_COEF;
+			for (const spatial::NearbyPair& pair : walk_pairs_) {
+				const double time = pair.distance / velocity;
+				graphs_.AddEdge(graph::Edge<double>()
+					.SetEdgeType(graph::EdgeType::walk)
+					.SetVertexFromId(GetWaitVertex(pair.from))
+					.SetVertexToId(GetWaitVertex(pair.to))
+					.SetEdgeWeight(time)
+					.SetEdgeName(transport_catalogue_.GetStopName(pair.to))
+					.SetEdgeSpanCount(0));
+				graphs_.AddEdge(graph::Edge<double>()
+					.SetEdgeType(graph::EdgeType::walk)
+					.SetVertexFromId(GetWaitVertex(pair.to))
+					.SetVertexToId(GetWaitVertex(pair.from))
+					.SetEdgeWeight(time)
+					.SetEdgeName(transport_catalogue_.GetStopName(pair.from))
+					.SetEdgeSpanCount(0));
+			}
+			_walk_edge_count = walk_pairs_.size() * 2;
+			walk_pairs_.clear();
+			walk_pairs_.shrink_to_fit();
+		}
+
+		void TransportRouter::ReserveGraph() {
+
+			const StopId stops_count = static_cast<StopId>(transport_catalogue_.GetStopsCount());
+			//              
+			std::vector<size_t> wait_degrees(stops_count, 1U);
+			std::vector<size_t> move_degrees(stops_count, 0U);
+			size_t edge_count = stops_count;
+
+			walk_pairs_.clear();
+			if (_settings.IsWalkingEnabled()) {
+				std::vector<geo::Coordinates> coordinates;
+				coordinates.reserve(stops_count);
+				for (StopId id = 0; id != stops_count; ++id) {
+					coordinates.push_back(transport_catalogue_.GetStopCoordinates(id));
+				}
+				walk_pairs_ = spatial::FindPairsWithin(coordinates, _settings.GetWalkingRadius());
+				for (const spatial::NearbyPair& pair : walk_pairs_) {
+					++wait_degrees[pair.from];
+					++wait_degrees[pair.to];
+				}
+				edge_count += walk_pairs_.size() * 2;
+			}
+
+			const BusId buses_count = static_cast<BusId>(transport_catalogue_.GetBusesCount());
+			for (BusId id = 0; id != buses_count; ++id) {
+				const auto stops = transport_catalogue_.GetBusStopIds(id);
+				for (size_t from_stop_id = 0; from_stop_id != stops.size(); ++from_stop_id) {
+					const size_t edges = stops.size() - from_stop_id - 1;
+					move_degrees[stops[from_stop_id]] += edges;
+					edge_count += edges;
+				}
+			}
+
+			graphs_.ReserveEdges(edge_count);
+			for (StopId id = 0; id != stops_count; ++id) {
+				graphs_.ReserveIncidentEdges(GetWaitVertex(id), wait_degrees[id]);
+				graphs_.ReserveIncidentEdges(GetMoveVertex(id), move_degrees[id]);
+			}
+		}
+
+		void TransportRouter::BuildRouter() {
+			if (_router) {
+				return;
+			}
+			//         ,    
+			EnsureGraph();
+			_router = std::make_unique<graph::Router<double>>(graphs_, _settings.GetHugePagePolicy());
 		}
 
 	}   
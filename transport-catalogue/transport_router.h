@@ -5,9 +5,12 @@
 
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include <string_view>
+#include <atomic>
 #include <future>
+#include <mutex>
 
 namespace transport_catalogue {
 
@@ -22,26 +25,42 @@ namespace transport_catalogue {
 
 			RouterSettings& SetBusWaitTime(size_t);
 			RouterSettings& SetBusVelocity(double);
+			RouterSettings& SetHugePagePolicy(memory::HugePagePolicy);
+			RouterSettings& SetWalkingRadius(double);
+			RouterSettings& SetWalkingVelocity(double);
 
 			size_t GetBusWaitTime() const;
 			double GetBusVelocity() const;
+			memory::HugePagePolicy GetHugePagePolicy() const;
+			double GetWalkingRadius() const;
+			double GetWalkingVelocity() const;
+			// Пешие пересадки строятся, только если заданы и радиус, и скорость
+			bool IsWalkingEnabled() const;
 
 			size_t _bus_wait_time = {};
 			double _bus_velocity = {};
+			memory::HugePagePolicy _huge_page_policy = memory::HugePagePolicy::transparent;
+			// Пешком можно дойти до остановок не дальше _walking_radius метров по прямой
+			// со скоростью _walking_velocity км/ч; 0 - пешие пересадки отключены
+			double _walking_radius = {};
+			double _walking_velocity = {};
 		};
 
 		class TransportRouter {
 		private:
-			transport_catalogue::TransportCatalogue& transport_catalogue_;
+			const transport_catalogue::TransportCatalogue& transport_catalogue_;
 		public:
 			TransportRouter() = default;
-			TransportRouter(transport_catalogue::TransportCatalogue&);
-			TransportRouter(transport_catalogue::TransportCatalogue&, const RouterSettings&);
-			TransportRouter(transport_catalogue::TransportCatalogue&, RouterSettings&&);
+			// Граф маршрутизации размещается в resource - при сборке базы это её арена
+			TransportRouter(const transport_catalogue::TransportCatalogue&,
+				std::pmr::memory_resource* = std::pmr::get_default_resource());
+			TransportRouter(const transport_catalogue::TransportCatalogue&, const RouterSettings&,
+				std::pmr::memory_resource* = std::pmr::get_default_resource());
+			TransportRouter(const transport_catalogue::TransportCatalogue&, RouterSettings&&,
+				std::pmr::memory_resource* = std::pmr::get_default_resource());
 
 			TransportRouter& SetRouterSettings(const RouterSettings&);
 			TransportRouter& SetRouterSettings(RouterSettings&&);
-			TransportRouter& SetRouterTransportCatalogue(transport_catalogue::TransportCatalogue&);
 
 			TransportRouter& SetRouterGraphs(graph::DirectedWeightedGraph<double>&&);
 			TransportRouter& SetRouterWaitPoints(std::unordered_map<std::string_view, size_t>&&);
@@ -52,54 +71,59 @@ namespace transport_catalogue {
 			const std::unordered_map<std::string_view, size_t>& GetRouterMovePoints() const;
 
 			TransportRouter& ImportRoutingDataFromCatalogue();
-
-			template <typename Iterator>
-			void BuidEdgeTask(Iterator first, Iterator last);
-
+			// Граф по изменённой копии каталога: рёбра маршрутов, не отмеченных в changed_buses,
+			// переносятся из графа previous, построенного по прежней версии с теми же остановками
+			// и маршрутами. Если перенос невозможен, граф строится по каталогу целиком
+			TransportRouter& ImportRoutingDataFromPrevious(const TransportRouter& previous, const std::vector<bool>& changed_buses);
+			// Строит граф по каталогу, если он ещё не заполнен; таблица маршрутов при этом не считается
+			void EnsureGraph();
+
+			// Строит рёбра движения для маршрутов с id из [first, last)
+			void BuidEdgeTask(BusId first, BusId last);
+
+			// Безопасны для одновременного вызова из нескольких потоков:
+			// маршрутизатор строится один раз при первом запросе
 			transport_catalogue::RouteStat MakeRoute(std::string_view, std::string_view);
+			transport_catalogue::RouteStat MakeRouteToAny(std::string_view, const std::vector<std::string_view>&);
+
+			// Вершины графа выводятся из id остановки без поиска по имени
+			static graph::VertexId GetWaitVertex(StopId id) {
+				return static_cast<graph::VertexId>(id) * 2;
+			}
+			static graph::VertexId GetMoveVertex(StopId id) {
+				return static_cast<graph::VertexId>(id) * 2 + 1;
+			}
 
 		private:
+			void BuildRouter();
+			void ImportGraph();
+			// Точки и рёбра ожидания идут в графе первыми, по одному на остановку
+			void ImportStops();
+			// Рёбра пеших пересадок идут в графе последними: из вершины ожидания одной остановки
+			// в вершину ожидания другой, поэтому у начальной остановки ждать не нужно, а у конечной
+			// ожидание, как и после поездки, отбрасывается при восстановлении маршрута
+			void ImportWalkEdges();
+			// Точное число рёбер и исходящих рёбер каждой вершины до построения графа.
+			// Заодно находит пары остановок для пеших пересадок
+			void ReserveGraph();
+			transport_catalogue::RouteStat MakeRouteStat(const std::optional<graph::Router<double>::RouteInfo>&) const;
+
 			RouterSettings _settings;
 
 			graph::DirectedWeightedGraph<double> graphs_;
 			std::unique_ptr<graph::Router<double>> _router = nullptr;
+			std::once_flag _router_built;
+			std::once_flag _graph_built;
+			// Граф заполнен и больше не меняется: из него можно переносить рёбра
+			std::atomic<bool> _graph_ready = false;
+			// Пары остановок в радиусе пешей доступности между ReserveGraph и ImportWalkEdges
+			std::vector<spatial::NearbyPair> walk_pairs_;
+			size_t _walk_edge_count = 0U;
 			std::unordered_map<std::string_view, size_t> wait_points_;
 			std::unordered_map<std::string_view, size_t> move_points_;
 
 		};
 
-		template<typename Iterator>
-		inline void TransportRouter::BuidEdgeTask(Iterator first, Iterator last)
-		{
-			for (; first != last; ++first) {
-
-				for (size_t from_stop_id = 0; from_stop_id != first->stops_.size(); ++from_stop_id) {
-
-					int span_count = 0;
-
-					for (size_t to_stop_id = from_stop_id + 1; to_stop_id != first->stops_.size(); ++to_stop_id) {
-
-						double route_distance = 0.0;
-
-						for (size_t current_point = from_stop_id + 1; current_point <= to_stop_id; ++current_point) {
-							route_distance += static_cast<double>(transport_catalogue_
-								.GetDistance(first->stops_[current_point - 1], first->stops_[current_point]));
-						}
-
-						graphs_.AddEdge(graph::Edge<double>()
-							.SetEdgeType(graph::EdgeType::move)
-							.SetVertexFromId(move_points_.at(first->stops_[from_stop_id]->name_))
-							.SetVertexToId(wait_points_.at(first->stops_[to_stop_id]->name_))
-							.SetEdgeWeight(route_distance / (_settings.GetBusVelocity() * VELOCITY_COEF))
-							.SetEdgeName(first->bus_name_)
-							.SetEdgeSpanCount(++span_count));
-					}
-
-				}
-
-			}
-		}
-
 	}
 
 }
\ No newline at end of file